@@ -0,0 +1,206 @@
+#ifndef HOST_ARDUINO_H
+#define HOST_ARDUINO_H
+
+// === Arduino core (host) ===
+// Стільки ядра arduino-esp32, скільки використовує прошивка. Час - віртуальний
+// (host_sim.h): delay() і millis() не чекають, а пересувають годинник.
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+#include <string>
+#include <time.h>
+#include <sys/time.h>
+
+#define HIGH 1
+#define LOW 0
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define IRAM_ATTR
+#define ADC_11db 3
+#define ARDUINO_ARCH_ESP32 1
+#define ESP32 1
+#define CONFIG_IDF_TARGET_ESP32C3 1
+
+// RTC RAM переживає deep sleep: host_sim зберігає цю секцію між завантаженнями
+#define RTC_DATA_ATTR __attribute__((section("rtc_fake_data")))
+#define RTC_NOINIT_ATTR RTC_DATA_ATTR
+
+using std::min;
+using std::max;
+
+template <class T, class L, class H>
+auto constrain(T amount, L low, H high) -> decltype(amount + low + high) {
+  return amount < low ? low : (amount > high ? high : amount);
+}
+
+// === Time ===
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// === GPIO / ADC ===
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int digitalPinToInterrupt(int pin);
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode);
+void detachInterrupt(uint8_t pin);
+int analogRead(uint8_t pin);
+uint32_t analogReadMilliVolts(uint8_t pin);
+void analogReadResolution(int bits);
+void analogSetAttenuation(int attenuation);
+void analogSetPinAttenuation(uint8_t pin, int attenuation);
+
+void configTime(long gmtOffsetS, int daylightOffsetS, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+void configTzTime(const char* tz, const char* server1, const char* server2 = nullptr,
+                  const char* server3 = nullptr);
+
+// === String ===
+class String {
+ public:
+  String(const char* text = "") : s(text ? text : "") {}
+  String(const std::string& text) : s(text) {}
+  explicit String(char c) : s(1, c) {}
+  String(int value) : s(std::to_string(value)) {}
+  String(unsigned value) : s(std::to_string(value)) {}
+  String(long value) : s(std::to_string(value)) {}
+  String(unsigned long value) : s(std::to_string(value)) {}
+  String(long long value) : s(std::to_string(value)) {}
+  String(unsigned long long value) : s(std::to_string(value)) {}
+  String(float value, unsigned decimals = 2) : s(formatFloat(value, decimals)) {}
+  String(double value, unsigned decimals = 2) : s(formatFloat(value, decimals)) {}
+
+  unsigned length() const { return s.size(); }
+  bool isEmpty() const { return s.empty(); }
+  const char* c_str() const { return s.c_str(); }
+  char charAt(unsigned index) const { return index < s.size() ? s[index] : '\0'; }
+  char operator[](unsigned index) const { return charAt(index); }
+
+  int indexOf(const String& what, unsigned from = 0) const { return found(s.find(what.s, from)); }
+  int indexOf(char what, unsigned from = 0) const { return found(s.find(what, from)); }
+  int lastIndexOf(char what) const { return found(s.rfind(what)); }
+  int lastIndexOf(const String& what) const { return found(s.rfind(what.s)); }
+  String substring(unsigned from) const { return from < s.size() ? String(s.substr(from)) : String(); }
+  String substring(unsigned from, unsigned to) const {
+    if (from > to) std::swap(from, to);
+    return from < s.size() ? String(s.substr(from, to - from)) : String();
+  }
+  bool startsWith(const String& prefix) const { return s.compare(0, prefix.s.size(), prefix.s) == 0; }
+  bool endsWith(const String& suffix) const {
+    return s.size() >= suffix.s.size() && s.compare(s.size() - suffix.s.size(), suffix.s.size(), suffix.s) == 0;
+  }
+  bool equals(const String& other) const { return s == other.s; }
+  bool equalsIgnoreCase(const String& other) const {
+    String a = *this;
+    String b = other;
+    a.toLowerCase();
+    b.toLowerCase();
+    return a.s == b.s;
+  }
+
+  long toInt() const { return atol(s.c_str()); }
+  float toFloat() const { return static_cast<float>(atof(s.c_str())); }
+  void trim() {
+    size_t first = s.find_first_not_of(" \t\r\n");
+    size_t last = s.find_last_not_of(" \t\r\n");
+    s = first == std::string::npos ? std::string() : s.substr(first, last - first + 1);
+  }
+  void toLowerCase() {
+    for (char& c : s) c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  }
+  void toUpperCase() {
+    for (char& c : s) c = static_cast<char>(toupper(static_cast<unsigned char>(c)));
+  }
+  void replace(const String& from, const String& to) {
+    if (from.s.empty()) return;
+    for (size_t pos = s.find(from.s); pos != std::string::npos; pos = s.find(from.s, pos + to.s.size())) {
+      s.replace(pos, from.s.size(), to.s);
+    }
+  }
+  void remove(unsigned index) { if (index < s.size()) s.erase(index); }
+  void remove(unsigned index, unsigned count) { if (index < s.size()) s.erase(index, count); }
+  bool reserve(unsigned size) {
+    s.reserve(size);
+    return true;
+  }
+  bool concat(const char* text, unsigned len) {
+    s.append(text, len);
+    return true;
+  }
+  void toCharArray(char* buf, unsigned size) const {
+    if (size == 0) return;
+    size_t n = std::min<size_t>(size - 1, s.size());
+    memcpy(buf, s.data(), n);
+    buf[n] = '\0';
+  }
+
+  String& operator+=(const String& other) { s += other.s; return *this; }
+  String& operator+=(const char* other) { s += other ? other : ""; return *this; }
+  String& operator+=(char c) { s += c; return *this; }
+  String& operator+=(int value) { s += std::to_string(value); return *this; }
+  String& operator+=(unsigned value) { s += std::to_string(value); return *this; }
+  String& operator+=(long value) { s += std::to_string(value); return *this; }
+  String& operator+=(unsigned long value) { s += std::to_string(value); return *this; }
+  bool operator==(const String& other) const { return s == other.s; }
+  bool operator==(const char* other) const { return s == (other ? other : ""); }
+  bool operator!=(const String& other) const { return s != other.s; }
+  bool operator!=(const char* other) const { return s != (other ? other : ""); }
+  bool operator<(const String& other) const { return s < other.s; }
+
+ private:
+  std::string s;
+
+  static int found(size_t pos) { return pos == std::string::npos ? -1 : static_cast<int>(pos); }
+  // Як dtostrf() ядра: фіксована кількість знаків після коми
+  static std::string formatFloat(double value, unsigned decimals) {
+    char buf[48];
+    snprintf(buf, sizeof(buf), "%.*f", static_cast<int>(decimals), value);
+    return buf;
+  }
+};
+
+inline String operator+(const String& a, const String& b) {
+  String out = a;
+  out += b;
+  return out;
+}
+inline String operator+(const String& a, const char* b) {
+  String out = a;
+  out += b;
+  return out;
+}
+inline String operator+(const char* a, const String& b) {
+  String out = a;
+  out += b;
+  return out;
+}
+inline String operator+(const String& a, char b) {
+  String out = a;
+  out += b;
+  return out;
+}
+
+// === Serial ===
+class HardwareSerial {
+ public:
+  void begin(unsigned long baud) { (void)baud; }
+  void flush();
+  size_t print(const String& text);
+  size_t println(const String& text = String());
+  size_t printf(const char* format, ...) __attribute__((format(printf, 2, 3)));
+};
+
+extern HardwareSerial Serial;
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef HOST_ESP32SERVO_H
+#define HOST_ESP32SERVO_H
+
+#include "Arduino.h"
+
+// === Servo (host) ===
+// Лише стан: рух і так займає віртуальний час через delay() у servo_motion
+class Servo {
+ public:
+  void setPeriodHertz(int hertz) { (void)hertz; }
+  int attach(int pin, int minUs = 544, int maxUs = 2400) {
+    (void)minUs;
+    (void)maxUs;
+    attachedPin = pin;
+    return 1;
+  }
+  void detach() { attachedPin = -1; }
+  bool attached() const { return attachedPin >= 0; }
+  void write(int angle) { pulseUs = 544 + angle * (2400 - 544) / 180; }
+  void writeMicroseconds(int us) { pulseUs = us; }
+  int readMicroseconds() const { return pulseUs; }
+
+ private:
+  int attachedPin = -1;
+  int pulseUs = 0;
+};
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef HOST_ESPMDNS_H
+#define HOST_ESPMDNS_H
+
+#include "Arduino.h"
+
+// === mDNS (host) ===
+class MDNSResponder {
+ public:
+  bool begin(const char* hostName) { (void)hostName; return true; }
+  void end() {}
+  void addService(const char* service, const char* proto, uint16_t port) {
+    (void)service;
+    (void)proto;
+    (void)port;
+  }
+};
+
+extern MDNSResponder MDNS;
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef HOST_PREFERENCES_H
+#define HOST_PREFERENCES_H
+
+#include "Arduino.h"
+
+// === Preferences (host) ===
+// NVS у спільній пам'яті host_sim: переживає deep sleep і вимкнення живлення.
+// Як у справжньому Preferences: ключ до 15 символів, float - це blob,
+// читання іншого типу повертає значення за замовчуванням.
+class Preferences {
+ public:
+  bool begin(const char* name, bool readOnly = false);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+
+  size_t putUChar(const char* key, uint8_t value) { return putInt64(key, value, 1); }
+  size_t putUShort(const char* key, uint16_t value) { return putInt64(key, value, 2); }
+  size_t putShort(const char* key, int16_t value) { return putInt64(key, value, 2); }
+  size_t putInt(const char* key, int32_t value) { return putInt64(key, value, 4); }
+  size_t putUInt(const char* key, uint32_t value) { return putInt64(key, value, 4); }
+  size_t putLong64(const char* key, int64_t value) { return putInt64(key, value, 8); }
+  size_t putULong64(const char* key, uint64_t value) { return putInt64(key, static_cast<int64_t>(value), 8); }
+  size_t putBool(const char* key, bool value) { return putInt64(key, value ? 1 : 0, 1); }
+  size_t putFloat(const char* key, float value) { return putBytes(key, &value, sizeof(value)); }
+  size_t putDouble(const char* key, double value) { return putBytes(key, &value, sizeof(value)); }
+  size_t putString(const char* key, const String& value);
+  size_t putBytes(const char* key, const void* value, size_t len);
+
+  uint8_t getUChar(const char* key, uint8_t fallback = 0) { return static_cast<uint8_t>(getInt64(key, fallback)); }
+  uint16_t getUShort(const char* key, uint16_t fallback = 0) { return static_cast<uint16_t>(getInt64(key, fallback)); }
+  int16_t getShort(const char* key, int16_t fallback = 0) { return static_cast<int16_t>(getInt64(key, fallback)); }
+  int32_t getInt(const char* key, int32_t fallback = 0) { return static_cast<int32_t>(getInt64(key, fallback)); }
+  uint32_t getUInt(const char* key, uint32_t fallback = 0) { return static_cast<uint32_t>(getInt64(key, fallback)); }
+  int64_t getLong64(const char* key, int64_t fallback = 0) { return getInt64(key, fallback); }
+  uint64_t getULong64(const char* key, uint64_t fallback = 0) {
+    return static_cast<uint64_t>(getInt64(key, static_cast<int64_t>(fallback)));
+  }
+  bool getBool(const char* key, bool fallback = false) { return getInt64(key, fallback ? 1 : 0) != 0; }
+  float getFloat(const char* key, float fallback = 0.0f) {
+    float value = fallback;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : fallback;
+  }
+  double getDouble(const char* key, double fallback = 0.0) {
+    double value = fallback;
+    return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : fallback;
+  }
+  String getString(const char* key, const String& fallback = String());
+  size_t getBytesLength(const char* key);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+
+ private:
+  char ns[16] = {};
+  bool started = false;
+  bool readOnly = false;
+
+  size_t putInt64(const char* key, int64_t value, size_t width);
+  int64_t getInt64(const char* key, int64_t fallback);
+};
+
+#endif
@@ -0,0 +1,73 @@
+#ifndef HOST_WEBSERVER_H
+#define HOST_WEBSERVER_H
+
+#include "Arduino.h"
+#include <functional>
+#include <map>
+#include <vector>
+
+// === WebServer (host) ===
+// Без мережі: запити подає тест через hostHttpRequest() з процесу прошивки
+// (hostAt()), обробник виконується так само, як з handleClient().
+enum HTTPMethod { HTTP_ANY, HTTP_GET, HTTP_POST };
+
+#define CONTENT_LENGTH_UNKNOWN ((size_t)-1)
+
+class WiFiClient {
+ public:
+  uint8_t connected() { return 0; }
+  size_t write(const uint8_t* data, size_t len) { (void)data; return len; }
+};
+
+struct HostHttpResponse {
+  int code = 0;
+  String contentType;
+  String body;
+};
+
+class WebServer {
+ public:
+  typedef std::function<void()> THandlerFunction;
+
+  explicit WebServer(int port = 80);
+  void begin() {}
+  void handleClient() {}
+  void on(const char* uri, THandlerFunction handler) { routes[uri] = handler; }
+  void on(const char* uri, HTTPMethod method, THandlerFunction handler) {
+    (void)method;
+    routes[uri] = handler;
+  }
+  void onNotFound(THandlerFunction handler) { notFound = handler; }
+  String uri() { return currentUri; }
+  bool hasArg(const char* name) { return args.count(name) > 0; }
+  String arg(const char* name) {
+    auto it = args.find(name);
+    return it == args.end() ? String() : String(it->second);
+  }
+  void send(int code, const char* contentType = nullptr, const String& body = String());
+  void send(int code, const char* contentType, const char* body) { send(code, contentType, String(body)); }
+  void send_P(int code, const char* contentType, const char* body, size_t len);
+  void sendHeader(const char* name, const String& value, bool first = false) {
+    (void)name;
+    (void)value;
+    (void)first;
+  }
+  void setContentLength(size_t len) { (void)len; }
+  void sendContent(const String& content) { response.body += content; }
+  WiFiClient& client() { return currentClient; }
+
+  HostHttpResponse request(const char* uri, const char* query);
+
+ private:
+  std::map<std::string, THandlerFunction> routes;
+  THandlerFunction notFound;
+  std::map<std::string, std::string> args;
+  String currentUri;
+  HostHttpResponse response;
+  WiFiClient currentClient;
+};
+
+// Запит до сервера прошивки: query - "a=1&b=2" без URL-кодування
+HostHttpResponse hostHttpRequest(const char* uri, const char* query = "");
+
+#endif
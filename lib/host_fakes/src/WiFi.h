@@ -0,0 +1,79 @@
+#ifndef HOST_WIFI_H
+#define HOST_WIFI_H
+
+#include "Arduino.h"
+#include "esp_wifi.h"
+
+// === WiFi (host) ===
+// Асоціація займає wifiConnectMs віртуального часу (wifiCachedConnectMs за
+// кешованим BSSID), потім приходить ARDUINO_EVENT_WIFI_STA_GOT_IP.
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum { WIFI_OFF = 0, WIFI_STA = 1, WIFI_AP = 2, WIFI_AP_STA = 3 } wifi_mode_t;
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_STA_CONNECTED = 4,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED = 5,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP = 7,
+  ARDUINO_EVENT_MAX = 64
+} arduino_event_id_t;
+
+typedef arduino_event_id_t WiFiEvent_t;
+typedef struct {
+  int reserved;
+} arduino_event_info_t;
+typedef arduino_event_info_t WiFiEventInfo_t;
+typedef void (*WiFiEventCb)(WiFiEvent_t event);
+typedef void (*WiFiEventFuncCb)(WiFiEvent_t event, WiFiEventInfo_t info);
+
+class IPAddress {
+ public:
+  IPAddress(uint8_t a = 0, uint8_t b = 0, uint8_t c = 0, uint8_t d = 0) : octets{a, b, c, d} {}
+  uint8_t operator[](int index) const { return octets[index & 3]; }
+  String toString() const;
+
+ private:
+  uint8_t octets[4];
+};
+
+class WiFiClass {
+ public:
+  bool mode(wifi_mode_t mode);
+  wifi_mode_t getMode() { return currentMode; }
+  wl_status_t begin(const char* ssid, const char* password = nullptr, int32_t channel = 0,
+                    const uint8_t* bssid = nullptr, bool connect = true);
+  bool reconnect();
+  bool disconnect(bool wifiOff = false, bool eraseAp = false);
+  wl_status_t status() { return currentStatus; }
+  IPAddress localIP();
+  uint8_t* BSSID();
+  int32_t channel();
+  int8_t RSSI() { return currentStatus == WL_CONNECTED ? -58 : 0; }
+  bool setSleep(bool enabled) { (void)enabled; return true; }
+  bool setAutoReconnect(bool enabled) { (void)enabled; return true; }
+  bool persistent(bool enabled) { (void)enabled; return true; }
+  bool softAP(const char* ssid, const char* password = nullptr);
+  bool softAPdisconnect(bool wifiOff = false);
+  IPAddress softAPIP() { return IPAddress(192, 168, 4, 1); }
+  int onEvent(WiFiEventCb callback, WiFiEvent_t event = ARDUINO_EVENT_MAX);
+  int onEvent(WiFiEventFuncCb callback, WiFiEvent_t event = ARDUINO_EVENT_MAX);
+
+ private:
+  wifi_mode_t currentMode = WIFI_OFF;
+  wl_status_t currentStatus = WL_DISCONNECTED;
+  int connectEvent = 0;
+
+  void startConnect(bool cached);
+  void dropLink();
+  void emit(WiFiEvent_t event);
+};
+
+extern WiFiClass WiFi;
+
+#endif
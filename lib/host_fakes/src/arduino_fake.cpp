@@ -0,0 +1,139 @@
+#include "Arduino.h"
+#include "host_internal.h"
+#include <stdarg.h>
+
+HardwareSerial Serial;
+
+// === Time ===
+unsigned long millis() {
+  hostClockRead();
+  return static_cast<unsigned long>(hostUptimeUs() / 1000);
+}
+
+unsigned long micros() {
+  hostClockRead();
+  return static_cast<unsigned long>(hostUptimeUs());
+}
+
+void delay(unsigned long ms) {
+  hostAdvance(static_cast<uint64_t>(ms) * 1000ULL);
+}
+
+void delayMicroseconds(unsigned int us) {
+  hostAdvance(us);
+}
+
+void yield() {}
+
+// Стінний годинник newlib на ESP32 рахується від RTC: переживає deep sleep,
+// обнуляється при втраті живлення. Ці визначення перекривають libc хоста.
+extern "C" time_t time(time_t* out) __THROW {
+  time_t now = static_cast<time_t>(hostWallUs() / 1000000LL);
+  if (out) *out = now;
+  return now;
+}
+
+extern "C" int gettimeofday(struct timeval* tv, void* tz) __THROW {
+  (void)tz;
+  int64_t us = hostWallUs();
+  tv->tv_sec = static_cast<time_t>(us / 1000000LL);
+  tv->tv_usec = static_cast<suseconds_t>(us % 1000000LL);
+  return 0;
+}
+
+extern "C" int settimeofday(const struct timeval* tv, const struct timezone* tz) __THROW {
+  (void)tz;
+  if (tv) hostSetWallUs(static_cast<int64_t>(tv->tv_sec) * 1000000LL + tv->tv_usec);
+  return 0;
+}
+
+void configTime(long gmtOffsetS, int daylightOffsetS, const char* server1, const char* server2,
+                const char* server3) {
+  (void)gmtOffsetS;
+  (void)daylightOffsetS;
+  (void)server1;
+  (void)server2;
+  (void)server3;
+  hostSntpStart();
+}
+
+void configTzTime(const char* tz, const char* server1, const char* server2, const char* server3) {
+  (void)tz;
+  configTime(0, 0, server1, server2, server3);
+}
+
+// === GPIO / ADC ===
+// Кнопка з підтяжкою не натиснута; АЦП віддає мілівольти, задані hostSetPinMillivolts()
+void pinMode(uint8_t pin, uint8_t mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t value) {
+  (void)pin;
+  (void)value;
+}
+
+int digitalRead(uint8_t pin) {
+  (void)pin;
+  return HIGH;
+}
+
+int digitalPinToInterrupt(int pin) {
+  return pin;
+}
+
+void attachInterrupt(uint8_t pin, void (*isr)(), int mode) {
+  (void)pin;
+  (void)isr;
+  (void)mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  (void)pin;
+}
+
+int analogRead(uint8_t pin) {
+  return pin < HOST_PINS ? static_cast<int>(host->pinMv[pin]) : 0;
+}
+
+uint32_t analogReadMilliVolts(uint8_t pin) {
+  return static_cast<uint32_t>(analogRead(pin));
+}
+
+void analogReadResolution(int bits) {
+  (void)bits;
+}
+
+void analogSetAttenuation(int attenuation) {
+  (void)attenuation;
+}
+
+void analogSetPinAttenuation(uint8_t pin, int attenuation) {
+  (void)pin;
+  (void)attenuation;
+}
+
+// === Serial ===
+void HardwareSerial::flush() {
+  if (host->config.echoSerial) fflush(stdout);
+}
+
+size_t HardwareSerial::print(const String& text) {
+  if (host->config.echoSerial) fputs(text.c_str(), stdout);
+  return text.length();
+}
+
+size_t HardwareSerial::println(const String& text) {
+  if (host->config.echoSerial) printf("%s\n", text.c_str());
+  return text.length() + 1;
+}
+
+size_t HardwareSerial::printf(const char* format, ...) {
+  if (!host->config.echoSerial) return 0;
+  va_list args;
+  va_start(args, format);
+  int written = vprintf(format, args);
+  va_end(args);
+  return written > 0 ? static_cast<size_t>(written) : 0;
+}
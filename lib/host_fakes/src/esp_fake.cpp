@@ -0,0 +1,247 @@
+#include "host_internal.h"
+#include "ESPmDNS.h"
+#include <esp_adc_cal.h>
+#include <esp_partition.h>
+#include <esp_sleep.h>
+#include <esp_system.h>
+#include <esp_timer.h>
+#include <driver/gpio.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+#include <string.h>
+#include <deque>
+#include <vector>
+
+MDNSResponder MDNS;
+
+// === Sleep ===
+static uint64_t timerWakeupUs = 0;
+static bool wakeCauseLoaded = false;
+static esp_sleep_wakeup_cause_t wakeCause = ESP_SLEEP_WAKEUP_UNDEFINED;
+
+esp_err_t esp_sleep_enable_timer_wakeup(uint64_t timeUs) {
+  timerWakeupUs = timeUs;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_enable_gpio_wakeup() {
+  return ESP_OK;
+}
+
+esp_err_t esp_deep_sleep_enable_gpio_wakeup(uint64_t mask, esp_deepsleep_gpio_wake_up_mode_t mode) {
+  (void)mask;
+  (void)mode;
+  return ESP_OK;
+}
+
+esp_err_t esp_sleep_disable_wakeup_source(esp_sleep_source_t source) {
+  if (source == ESP_SLEEP_WAKEUP_TIMER || source == ESP_SLEEP_WAKEUP_ALL) timerWakeupUs = 0;
+  return ESP_OK;
+}
+
+// Кнопку в симуляції не натискають: будить лише таймер
+esp_err_t esp_light_sleep_start() {
+  if (timerWakeupUs == 0) return ESP_ERR_INVALID_STATE;
+  hostNoteLightSleep(timerWakeupUs);
+  hostAdvance(timerWakeupUs);
+  wakeCauseLoaded = true;
+  wakeCause = ESP_SLEEP_WAKEUP_TIMER;
+  return ESP_OK;
+}
+
+void esp_deep_sleep_start() {
+  hostExit(HOST_EXIT_DEEP_SLEEP, timerWakeupUs);
+}
+
+esp_sleep_wakeup_cause_t esp_sleep_get_wakeup_cause() {
+  if (!wakeCauseLoaded) {
+    wakeCauseLoaded = true;
+    wakeCause = static_cast<esp_sleep_wakeup_cause_t>(host->wakeCause);
+  }
+  return wakeCause;
+}
+
+// === System ===
+esp_reset_reason_t esp_reset_reason() {
+  return static_cast<esp_reset_reason_t>(host->resetReason);
+}
+
+void esp_restart() {
+  hostExit(HOST_EXIT_RESTART, 0);
+}
+
+uint32_t esp_get_free_heap_size() {
+  return 200000;
+}
+
+// === Timer ===
+struct esp_timer {
+  esp_timer_cb_t callback;
+  void* arg;
+  uint64_t periodUs;
+  int event;
+};
+
+static void armTimer(esp_timer_handle_t timer, uint64_t delayUs) {
+  timer->event = hostScheduleEvent(static_cast<int64_t>(delayUs), [timer]() {
+    timer->event = 0;
+    if (timer->periodUs) armTimer(timer, timer->periodUs);
+    timer->callback(timer->arg);
+  });
+}
+
+int64_t esp_timer_get_time() {
+  hostClockRead();
+  return hostUptimeUs();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t* args, esp_timer_handle_t* out) {
+  if (!args || !args->callback || !out) return ESP_ERR_INVALID_ARG;
+  *out = new esp_timer{args->callback, args->arg, 0, 0};
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeoutUs) {
+  if (!timer) return ESP_ERR_INVALID_ARG;
+  if (timer->event) return ESP_ERR_INVALID_STATE;
+  timer->periodUs = 0;
+  armTimer(timer, timeoutUs);
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_start_periodic(esp_timer_handle_t timer, uint64_t periodUs) {
+  if (!timer || periodUs == 0) return ESP_ERR_INVALID_ARG;
+  if (timer->event) return ESP_ERR_INVALID_STATE;
+  timer->periodUs = periodUs;
+  armTimer(timer, periodUs);
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer) {
+  if (!timer) return ESP_ERR_INVALID_ARG;
+  if (!timer->event) return ESP_ERR_INVALID_STATE;
+  hostCancelEvent(timer->event);
+  timer->event = 0;
+  timer->periodUs = 0;
+  return ESP_OK;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer) {
+  if (!timer) return ESP_ERR_INVALID_ARG;
+  if (timer->event) return ESP_ERR_INVALID_STATE;
+  delete timer;
+  return ESP_OK;
+}
+
+// === Partition ===
+static const size_t FLASH_SECTOR_SIZE = 4096;
+static const esp_partition_t eventLogPartition = {
+  ESP_PARTITION_TYPE_DATA, 0x40, 0x290000, HOST_FLASH_SIZE, FLASH_SECTOR_SIZE, "eventlog", false
+};
+
+const esp_partition_t* esp_partition_find_first(esp_partition_type_t type, esp_partition_subtype_t subtype,
+                                                const char* label) {
+  if (type != eventLogPartition.type) return nullptr;
+  if (subtype != ESP_PARTITION_SUBTYPE_ANY && subtype != eventLogPartition.subtype) return nullptr;
+  if (label && strcmp(label, eventLogPartition.label) != 0) return nullptr;
+  return &eventLogPartition;
+}
+
+static bool inPartition(const esp_partition_t* partition, size_t offset, size_t size) {
+  return partition == &eventLogPartition && offset <= partition->size && size <= partition->size - offset;
+}
+
+esp_err_t esp_partition_read(const esp_partition_t* partition, size_t offset, void* dst, size_t size) {
+  if (!dst || !inPartition(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+  memcpy(dst, host->flash + offset, size);
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_write(const esp_partition_t* partition, size_t offset, const void* src, size_t size) {
+  if (!src || !inPartition(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+  const uint8_t* bytes = static_cast<const uint8_t*>(src);
+  for (size_t i = 0; i < size; ++i) host->flash[offset + i] &= bytes[i];
+  return ESP_OK;
+}
+
+esp_err_t esp_partition_erase_range(const esp_partition_t* partition, size_t offset, size_t size) {
+  if (!inPartition(partition, offset, size)) return ESP_ERR_INVALID_ARG;
+  if (offset % FLASH_SECTOR_SIZE != 0 || size % FLASH_SECTOR_SIZE != 0) return ESP_ERR_INVALID_SIZE;
+  memset(host->flash + offset, 0xFF, size);
+  return ESP_OK;
+}
+
+// === ADC ===
+esp_adc_cal_value_t esp_adc_cal_characterize(adc_unit_t unit, adc_atten_t atten, adc_bits_width_t width,
+                                             uint32_t defaultVref, esp_adc_cal_characteristics_t* chars) {
+  (void)width;
+  if (chars) *chars = {unit, atten, defaultVref};
+  return ESP_ADC_CAL_VAL_EFUSE_TP;
+}
+
+uint32_t esp_adc_cal_raw_to_voltage(uint32_t raw, const esp_adc_cal_characteristics_t* chars) {
+  (void)chars;
+  return raw;
+}
+
+// === GPIO ===
+esp_err_t gpio_wakeup_enable(gpio_num_t pin, gpio_int_type_t type) {
+  (void)pin;
+  (void)type;
+  return ESP_OK;
+}
+
+esp_err_t gpio_wakeup_disable(gpio_num_t pin) {
+  (void)pin;
+  return ESP_OK;
+}
+
+esp_err_t gpio_hold_en(gpio_num_t pin) {
+  (void)pin;
+  return ESP_OK;
+}
+
+esp_err_t gpio_hold_dis(gpio_num_t pin) {
+  (void)pin;
+  return ESP_OK;
+}
+
+// === FreeRTOS ===
+struct HostQueue {
+  UBaseType_t length;
+  UBaseType_t itemSize;
+  std::deque<std::vector<uint8_t>> items;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  return new HostQueue{length, itemSize, {}};
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t wait) {
+  (void)wait;
+  if (!queue || queue->items.size() >= queue->length) return pdFALSE;
+  const uint8_t* bytes = static_cast<const uint8_t*>(item);
+  queue->items.emplace_back(bytes, bytes + queue->itemSize);
+  return pdTRUE;
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+  if (woken) *woken = pdFALSE;
+  return xQueueSend(queue, item, 0);
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* item, TickType_t wait) {
+  (void)wait;
+  if (!queue || queue->items.empty()) return pdFALSE;
+  memcpy(item, queue->items.front().data(), queue->itemSize);
+  queue->items.pop_front();
+  return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  return queue ? static_cast<UBaseType_t>(queue->items.size()) : 0;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  hostAdvance(static_cast<uint64_t>(ticks) * 1000ULL);
+}
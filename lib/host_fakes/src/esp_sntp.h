@@ -0,0 +1,13 @@
+#ifndef HOST_ESP_SNTP_H
+#define HOST_ESP_SNTP_H
+
+#include <sys/time.h>
+
+// === SNTP (host) ===
+// configTime() запускає синхронізацію: через sntpReplyMs після отримання IP
+// годинник стає справжнім часом host_sim, далі - раз на годину
+typedef void (*sntp_sync_time_cb_t)(struct timeval* tv);
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback);
+
+#endif
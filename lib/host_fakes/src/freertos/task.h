@@ -0,0 +1,9 @@
+#ifndef HOST_FREERTOS_TASK_H
+#define HOST_FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+// === FreeRTOS task (host) ===
+void vTaskDelay(TickType_t ticks);
+
+#endif
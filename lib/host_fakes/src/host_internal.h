@@ -0,0 +1,79 @@
+#ifndef HOST_INTERNAL_H
+#define HOST_INTERNAL_H
+
+#include "host_sim.h"
+#include <functional>
+
+// === Host simulation internals ===
+// Спільний стан живе в анонімному MAP_SHARED: батьківський процес і всі
+// відгалужені завантаження бачать ті самі NVS, флеш, RTC RAM і годинник.
+#define HOST_NVS_ENTRIES 96
+#define HOST_NVS_KEY_MAX 16
+#define HOST_NVS_VALUE_MAX 2048
+#define HOST_FLASH_SIZE 0x10000
+#define HOST_RTC_SIZE 16384
+#define HOST_SCRATCH_SIZE 4096
+#define HOST_MAX_ACTIONS 32
+#define HOST_MAX_POWER_CUTS 8
+#define HOST_PINS 32
+
+enum HostNvsType : uint8_t {
+  HOST_NVS_FREE = 0,
+  HOST_NVS_INT,       // цілі всіх ширин, як nvs_set_i32/u8/...
+  HOST_NVS_STR,
+  HOST_NVS_BLOB       // і float/double: Preferences пише їх як blob
+};
+
+struct HostNvsEntry {
+  char ns[HOST_NVS_KEY_MAX];
+  char key[HOST_NVS_KEY_MAX];
+  uint8_t type;
+  uint16_t len;
+  uint8_t data[HOST_NVS_VALUE_MAX];
+};
+
+struct HostPowerCut {
+  uint64_t atUs;
+  uint64_t offUs;
+  bool done;
+};
+
+struct HostShared {
+  HostSimConfig config;
+  int64_t simUs;            // монотонний віртуальний час від початку прогону
+  int64_t rtcOffsetUs;      // стінний час RTC = simUs + rtcOffsetUs
+  uint64_t untilUs;
+  HostPowerCut cuts[HOST_MAX_POWER_CUTS];
+  int cutCount;
+  // Стан для наступного завантаження
+  uint8_t resetReason;
+  uint8_t wakeCause;
+  bool rtcValid;
+  uint8_t rtc[HOST_RTC_SIZE];
+  HostBoot boot;
+  bool actionDone[HOST_MAX_ACTIONS];
+  uint32_t pinMv[HOST_PINS];
+  HostNvsEntry nvs[HOST_NVS_ENTRIES];
+  uint8_t flash[HOST_FLASH_SIZE];
+  uint8_t scratch[HOST_SCRATCH_SIZE];
+};
+
+extern HostShared* host;
+
+// === Host Internal Functions ===
+// Лише в процесі прошивки
+int64_t hostUptimeUs();
+int64_t hostWallUs();
+void hostSetWallUs(int64_t wallUs);
+void hostAdvance(uint64_t us);
+void hostClockRead();
+[[noreturn]] void hostExit(HostExit exit, uint64_t sleepUs);
+int hostScheduleEvent(int64_t delayUs, std::function<void()> fn);
+void hostCancelEvent(int id);
+void hostNoteLightSleep(uint64_t us);
+void hostNoteWifiConnect();
+void hostNoteWifiDown();
+void hostSntpStart();
+void hostSntpOnConnect();
+
+#endif
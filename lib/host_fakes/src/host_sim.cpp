@@ -0,0 +1,343 @@
+#include "host_internal.h"
+#include <esp_sntp.h>
+#include <algorithm>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/time.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include <vector>
+
+// Як у ядрі Arduino: точки входу прошивки
+void setup();
+void loop();
+
+// RTC_DATA_ATTR на хості кладе змінні в цю секцію (Arduino.h); межі дає компонувальник ELF
+extern uint8_t __start_rtc_fake_data[] __attribute__((weak));
+extern uint8_t __stop_rtc_fake_data[] __attribute__((weak));
+
+static const int64_t SNTP_PERIOD_US = 3600LL * 1000000LL;   // CONFIG_LWIP_SNTP_UPDATE_DELAY
+static const int64_t SNTP_RETRY_US = 15LL * 1000000LL;
+
+HostShared* host = nullptr;
+
+struct HostActionEntry {
+  uint64_t atUs;
+  HostAction action;
+};
+
+struct HostEvent {
+  int id;
+  int64_t atUs;
+  std::function<void()> fn;
+};
+
+// Батьківський процес: задаються до hostRun(), дочірні бачать копію
+static std::vector<HostActionEntry> actions;
+static HostExitHook exitHook = nullptr;
+static uint32_t bootIndex = 0;
+
+// Процес прошивки: власні для кожного завантаження
+static int64_t bootSimUs = 0;
+static std::vector<HostEvent> events;
+static int nextEventId = 1;
+static bool inEvent = false;
+static sntp_sync_time_cb_t sntpCallback = nullptr;
+static bool sntpRunning = false;
+static int sntpEvent = 0;
+static bool wifiLinkUp = false;
+
+static size_t rtcLength() {
+  if (!__start_rtc_fake_data || !__stop_rtc_fake_data) return 0;
+  return static_cast<size_t>(__stop_rtc_fake_data - __start_rtc_fake_data);
+}
+
+// Живлення з'явилось: RTC рахує від нуля, RTC RAM втрачено
+static void powerOn() {
+  host->rtcOffsetUs = -host->simUs;
+  host->rtcValid = false;
+  host->resetReason = 1;    // ESP_RST_POWERON
+  host->wakeCause = 0;      // ESP_SLEEP_WAKEUP_UNDEFINED
+}
+
+void hostSimReset(const HostSimConfig& config) {
+  if (!host) {
+    void* mem = mmap(nullptr, sizeof(HostShared), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+    if (mem == MAP_FAILED) {
+      perror("host_sim: mmap");
+      _exit(1);
+    }
+    host = static_cast<HostShared*>(mem);
+  }
+  memset(static_cast<void*>(host), 0, sizeof(HostShared));
+  host->config = config;
+  memset(host->flash, 0xFF, sizeof(host->flash));
+  actions.clear();
+  exitHook = nullptr;
+  bootIndex = 0;
+  powerOn();
+}
+
+void hostAt(uint64_t atS, HostAction action) {
+  if (actions.size() >= HOST_MAX_ACTIONS) return;
+  actions.push_back({atS * 1000000ULL, action});
+}
+
+void hostPowerCut(uint64_t atS, uint64_t offS) {
+  if (host->cutCount >= HOST_MAX_POWER_CUTS) return;
+  host->cuts[host->cutCount++] = {atS * 1000000ULL, offS * 1000000ULL, false};
+}
+
+void hostSetExitHook(HostExitHook hook) {
+  exitHook = hook;
+}
+
+void hostSetPinMillivolts(int pin, uint32_t mv) {
+  if (pin >= 0 && pin < HOST_PINS) host->pinMv[pin] = mv;
+}
+
+uint64_t hostNowUs() {
+  return static_cast<uint64_t>(host->simUs);
+}
+
+uint32_t hostTrueUtc() {
+  return host->config.startUtc + static_cast<uint32_t>(host->simUs / 1000000LL);
+}
+
+void* hostScratch(size_t* size) {
+  if (size) *size = sizeof(host->scratch);
+  return host->scratch;
+}
+
+const uint8_t* hostFlash(size_t* size) {
+  if (size) *size = sizeof(host->flash);
+  return host->flash;
+}
+
+// === Virtual clock ===
+int64_t hostUptimeUs() {
+  return host->simUs - bootSimUs;
+}
+
+int64_t hostWallUs() {
+  if (!host) return 0;
+  return host->simUs + host->rtcOffsetUs;
+}
+
+void hostSetWallUs(int64_t wallUs) {
+  host->rtcOffsetUs = wallUs - host->simUs;
+}
+
+static HostPowerCut* pendingCut() {
+  HostPowerCut* next = nullptr;
+  for (int i = 0; i < host->cutCount; ++i) {
+    HostPowerCut& cut = host->cuts[i];
+    if (!cut.done && (!next || cut.atUs < next->atUs)) next = &cut;
+  }
+  return next;
+}
+
+// Події (Wi-Fi, SNTP, esp_timer) спрацьовують у свій момент посеред очікування,
+// як в окремій задачі на залізі
+void hostAdvance(uint64_t us) {
+  const int64_t target = host->simUs + static_cast<int64_t>(us);
+  for (;;) {
+    HostPowerCut* cut = pendingCut();
+    if (cut && static_cast<int64_t>(cut->atUs) <= target) {
+      host->simUs = std::max(host->simUs, static_cast<int64_t>(cut->atUs));
+      hostExit(HOST_EXIT_POWER_CUT, 0);
+    }
+    if (inEvent) {
+      host->simUs = target;
+      return;
+    }
+    size_t due = events.size();
+    for (size_t i = 0; i < events.size(); ++i) {
+      if (events[i].atUs <= target && (due == events.size() || events[i].atUs < events[due].atUs)) due = i;
+    }
+    if (due == events.size()) {
+      host->simUs = target;
+      return;
+    }
+    HostEvent event = events[due];
+    events.erase(events.begin() + due);
+    host->simUs = std::max(host->simUs, event.atUs);
+    inEvent = true;
+    event.fn();
+    inEvent = false;
+  }
+}
+
+// Кожне читання часу коштує мікросекунду: цикли опитування без delay() теж просуваються
+void hostClockRead() {
+  if (inEvent) {
+    host->simUs++;
+    return;
+  }
+  hostAdvance(1);
+}
+
+int hostScheduleEvent(int64_t delayUs, std::function<void()> fn) {
+  int id = nextEventId++;
+  events.push_back({id, host->simUs + delayUs, fn});
+  return id;
+}
+
+void hostCancelEvent(int id) {
+  for (size_t i = 0; i < events.size(); ++i) {
+    if (events[i].id == id) {
+      events.erase(events.begin() + i);
+      return;
+    }
+  }
+}
+
+void hostNoteLightSleep(uint64_t us) {
+  host->boot.lightSleeps++;
+  host->boot.lightSleepUs += us;
+}
+
+// === SNTP ===
+// Синхронізація лише з мережею: відповідь приходить за sntpReplyMs, далі раз на годину
+static void sntpSync() {
+  sntpEvent = 0;
+  if (!sntpRunning) return;
+  if (!wifiLinkUp) {
+    sntpEvent = hostScheduleEvent(SNTP_RETRY_US, sntpSync);
+    return;
+  }
+  hostSetWallUs(static_cast<int64_t>(host->config.startUtc) * 1000000LL + host->simUs);
+  if (sntpCallback) {
+    struct timeval tv;
+    gettimeofday(&tv, nullptr);
+    sntpCallback(&tv);
+  }
+  sntpEvent = hostScheduleEvent(SNTP_PERIOD_US, sntpSync);
+}
+
+void sntp_set_time_sync_notification_cb(sntp_sync_time_cb_t callback) {
+  sntpCallback = callback;
+}
+
+void hostSntpStart() {
+  sntpRunning = true;
+  if (sntpEvent) hostCancelEvent(sntpEvent);
+  sntpEvent = hostScheduleEvent(host->config.sntpReplyMs * 1000LL, sntpSync);
+}
+
+void hostNoteWifiConnect() {
+  host->boot.wifiConnects++;
+  wifiLinkUp = true;
+}
+
+void hostSntpOnConnect() {
+  if (sntpRunning && !sntpEvent) sntpEvent = hostScheduleEvent(host->config.sntpReplyMs * 1000LL, sntpSync);
+}
+
+void hostNoteWifiDown() {
+  wifiLinkUp = false;
+}
+
+// === Boot cycle ===
+[[noreturn]] void hostExit(HostExit exit, uint64_t sleepUs) {
+  if (exitHook) exitHook(exit);
+  size_t rtcLen = rtcLength();
+  if ((exit == HOST_EXIT_DEEP_SLEEP || exit == HOST_EXIT_RESTART) && rtcLen <= sizeof(host->rtc)) {
+    memcpy(host->rtc, __start_rtc_fake_data, rtcLen);
+    host->rtcValid = true;
+  }
+  host->boot.endUs = host->simUs;
+  host->boot.sleepUs = sleepUs;
+  fflush(stdout);
+  _exit(exit);
+}
+
+static void runDueActions() {
+  for (size_t i = 0; i < actions.size(); ++i) {
+    if (!host->actionDone[i] && static_cast<int64_t>(actions[i].atUs) <= host->simUs) {
+      host->actionDone[i] = true;
+      actions[i].action();
+    }
+  }
+}
+
+[[noreturn]] static void runFirmware() {
+  bootSimUs = host->simUs;
+  size_t rtcLen = rtcLength();
+  if (rtcLen > sizeof(host->rtc)) {
+    fprintf(stderr, "host_sim: RTC_DATA_ATTR needs %zu bytes, fake RTC RAM has %zu\n", rtcLen, sizeof(host->rtc));
+    _exit(HOST_EXIT_CRASH);
+  }
+  if (host->rtcValid) memcpy(__start_rtc_fake_data, host->rtc, rtcLen);
+  hostAdvance(host->config.bootRomUs);
+  setup();
+  for (;;) {
+    loop();
+    runDueActions();
+    if (host->simUs >= static_cast<int64_t>(host->untilUs)) hostExit(HOST_EXIT_RUN_END, 0);
+    hostAdvance(host->config.loopPassUs);
+  }
+}
+
+// Сон і вимкнення живлення між завантаженнями - справа батьківського процесу
+static void sleepThrough(uint64_t sleepUs) {
+  const int64_t wakeUs = host->simUs + static_cast<int64_t>(sleepUs);
+  HostPowerCut* cut = pendingCut();
+  if (cut && static_cast<int64_t>(cut->atUs) < wakeUs) {
+    cut->done = true;
+    host->simUs = std::max(host->simUs, static_cast<int64_t>(cut->atUs + cut->offUs));
+    powerOn();
+    return;
+  }
+  host->simUs = wakeUs;
+  host->resetReason = 8;    // ESP_RST_DEEPSLEEP
+  host->wakeCause = 4;      // ESP_SLEEP_WAKEUP_TIMER
+}
+
+bool hostRun(uint64_t untilS, HostBootHook onBoot) {
+  host->untilUs = untilS * 1000000ULL;
+  while (host->simUs < static_cast<int64_t>(host->untilUs)) {
+    host->boot = {};
+    host->boot.index = bootIndex++;
+    host->boot.bootUs = host->simUs;
+    fflush(stdout);
+    pid_t pid = fork();
+    if (pid < 0) {
+      perror("host_sim: fork");
+      return false;
+    }
+    if (pid == 0) runFirmware();
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    HostExit exit = HOST_EXIT_CRASH;
+    if (WIFEXITED(status) && WEXITSTATUS(status) < HOST_EXIT_CRASH) exit = static_cast<HostExit>(WEXITSTATUS(status));
+    host->boot.exit = exit;
+    if (exit == HOST_EXIT_CRASH) host->boot.endUs = host->simUs;
+    if (onBoot) onBoot(host->boot);
+
+    switch (exit) {
+      case HOST_EXIT_DEEP_SLEEP:
+        sleepThrough(host->boot.sleepUs);
+        break;
+      case HOST_EXIT_RESTART:
+        host->resetReason = 3;    // ESP_RST_SW
+        host->wakeCause = 0;
+        break;
+      case HOST_EXIT_POWER_CUT: {
+        HostPowerCut* cut = pendingCut();
+        cut->done = true;
+        host->simUs += static_cast<int64_t>(cut->offUs);
+        powerOn();
+        break;
+      }
+      case HOST_EXIT_RUN_END:
+        return true;
+      case HOST_EXIT_CRASH:
+        return false;
+    }
+  }
+  return true;
+}
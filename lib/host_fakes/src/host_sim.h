@@ -0,0 +1,68 @@
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// === Host simulation ===
+// Прошивка на хості без змін: setup()/loop() крутяться на віртуальному годиннику.
+// delay(), light sleep і прохід loop() лише пересувають час, тож рік роботи
+// проганяється за секунди. Кожне завантаження - окремий процес, відгалужений
+// від незайманого батьківського: звичайні глобальні змінні після deep sleep
+// ініціалізуються заново, як на залізі, а NVS, розділ флешу і RTC_DATA_ATTR
+// переживають сон у спільній пам'яті.
+//
+// Обмеження: unsigned long на хості 64-бітний, тож переповнення millis()
+// раз на 49 діб тут не відтворюється; годинник RTC не дрейфує.
+
+enum HostExit : uint8_t {
+  HOST_EXIT_DEEP_SLEEP = 0,
+  HOST_EXIT_RESTART,
+  HOST_EXIT_POWER_CUT,
+  HOST_EXIT_RUN_END,
+  HOST_EXIT_CRASH
+};
+
+struct HostSimConfig {
+  uint32_t startUtc = 1767225600;      // 2026-01-01 00:00 UTC - справжній час для SNTP
+  uint32_t loopPassUs = 50000;         // вартість одного проходу loop()
+  uint32_t bootRomUs = 250000;         // ROM + завантажувач до setup()
+  uint32_t wifiConnectMs = 3000;       // сканування + асоціація + DHCP
+  uint32_t wifiCachedConnectMs = 800;  // за кешованим BSSID/каналом
+  uint32_t sntpReplyMs = 500;
+  bool wifiAvailable = true;
+  bool echoSerial = false;             // Serial прошивки - у stdout
+};
+
+// Підсумок одного завантаження, для батьківського процесу
+struct HostBoot {
+  uint32_t index;
+  HostExit exit;
+  uint64_t bootUs;                     // віртуальний час старту, мкс від початку прогону
+  uint64_t endUs;                      // віртуальний час виходу
+  uint64_t sleepUs;                    // замовлений deep sleep
+  uint32_t lightSleeps;
+  uint64_t lightSleepUs;
+  uint32_t wifiConnects;
+};
+
+typedef void (*HostAction)();
+typedef void (*HostExitHook)(HostExit exit);
+typedef void (*HostBootHook)(const HostBoot& boot);
+
+// === Host Sim Functions ===
+// Керування - з батьківського процесу (тест)
+void hostSimReset(const HostSimConfig& config);   // нова плата: порожні NVS і флеш, RTC без живлення
+void hostAt(uint64_t atS, HostAction action);      // у процесі прошивки, на межі проходу loop()
+void hostPowerCut(uint64_t atS, uint64_t offS);
+void hostSetExitHook(HostExitHook hook);           // у процесі прошивки, перед виходом
+void hostSetPinMillivolts(int pin, uint32_t mv);
+bool hostRun(uint64_t untilS, HostBootHook onBoot);
+uint64_t hostNowUs();
+uint32_t hostTrueUtc();
+// Спільна пам'ять для тесту: процес прошивки пише, батьківський читає
+void* hostScratch(size_t* size);
+// Розділ флешу "eventlog" як є
+const uint8_t* hostFlash(size_t* size);
+
+#endif
@@ -0,0 +1,107 @@
+#include "Preferences.h"
+#include "host_internal.h"
+
+static bool validKey(const char* key) {
+  return key && key[0] && strlen(key) < HOST_NVS_KEY_MAX;
+}
+
+static HostNvsEntry* findEntry(const char* ns, const char* key) {
+  for (HostNvsEntry& entry : host->nvs) {
+    if (entry.type != HOST_NVS_FREE && strcmp(entry.ns, ns) == 0 && strcmp(entry.key, key) == 0) return &entry;
+  }
+  return nullptr;
+}
+
+// Перезапис ключа тим самим або іншим типом займає ту саму комірку
+static HostNvsEntry* writeEntry(const char* ns, const char* key, uint8_t type, const void* data, size_t len) {
+  if (len > HOST_NVS_VALUE_MAX) return nullptr;
+  HostNvsEntry* entry = findEntry(ns, key);
+  for (int i = 0; !entry && i < HOST_NVS_ENTRIES; ++i) {
+    if (host->nvs[i].type == HOST_NVS_FREE) entry = &host->nvs[i];
+  }
+  if (!entry) return nullptr;
+  snprintf(entry->ns, sizeof(entry->ns), "%s", ns);
+  snprintf(entry->key, sizeof(entry->key), "%s", key);
+  entry->type = type;
+  entry->len = static_cast<uint16_t>(len);
+  memcpy(entry->data, data, len);
+  return entry;
+}
+
+bool Preferences::begin(const char* name, bool readOnlyMode) {
+  if (!name || strlen(name) >= sizeof(ns)) return false;
+  snprintf(ns, sizeof(ns), "%s", name);
+  started = true;
+  readOnly = readOnlyMode;
+  return true;
+}
+
+void Preferences::end() {
+  started = false;
+}
+
+bool Preferences::clear() {
+  if (!started || readOnly) return false;
+  for (HostNvsEntry& entry : host->nvs) {
+    if (entry.type != HOST_NVS_FREE && strcmp(entry.ns, ns) == 0) entry.type = HOST_NVS_FREE;
+  }
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!started || readOnly || !validKey(key)) return false;
+  HostNvsEntry* entry = findEntry(ns, key);
+  if (!entry) return false;
+  entry->type = HOST_NVS_FREE;
+  return true;
+}
+
+bool Preferences::isKey(const char* key) {
+  return started && validKey(key) && findEntry(ns, key) != nullptr;
+}
+
+size_t Preferences::putInt64(const char* key, int64_t value, size_t width) {
+  if (!started || readOnly || !validKey(key)) return 0;
+  return writeEntry(ns, key, HOST_NVS_INT, &value, sizeof(value)) ? width : 0;
+}
+
+int64_t Preferences::getInt64(const char* key, int64_t fallback) {
+  if (!started || !validKey(key)) return fallback;
+  HostNvsEntry* entry = findEntry(ns, key);
+  if (!entry || entry->type != HOST_NVS_INT) return fallback;
+  int64_t value = 0;
+  memcpy(&value, entry->data, sizeof(value));
+  return value;
+}
+
+size_t Preferences::putString(const char* key, const String& value) {
+  if (!started || readOnly || !validKey(key)) return 0;
+  return writeEntry(ns, key, HOST_NVS_STR, value.c_str(), value.length()) ? value.length() : 0;
+}
+
+String Preferences::getString(const char* key, const String& fallback) {
+  if (!started || !validKey(key)) return fallback;
+  HostNvsEntry* entry = findEntry(ns, key);
+  if (!entry || entry->type != HOST_NVS_STR) return fallback;
+  return String(std::string(reinterpret_cast<const char*>(entry->data), entry->len));
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!started || readOnly || !validKey(key) || !value || len == 0) return 0;
+  return writeEntry(ns, key, HOST_NVS_BLOB, value, len) ? len : 0;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!started || !validKey(key)) return 0;
+  HostNvsEntry* entry = findEntry(ns, key);
+  return entry && entry->type == HOST_NVS_BLOB ? entry->len : 0;
+}
+
+// Як nvs_get_blob(): буфер менший за значення - помилка, нічого не читаємо
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  if (!started || !validKey(key) || !buf) return 0;
+  HostNvsEntry* entry = findEntry(ns, key);
+  if (!entry || entry->type != HOST_NVS_BLOB || entry->len > maxLen) return 0;
+  memcpy(buf, entry->data, entry->len);
+  return entry->len;
+}
@@ -0,0 +1,50 @@
+#include "WebServer.h"
+
+// Прошивка створює один сервер; до нього і йдуть запити тесту
+static WebServer* activeServer = nullptr;
+
+WebServer::WebServer(int port) {
+  (void)port;
+  activeServer = this;
+}
+
+void WebServer::send(int code, const char* contentType, const String& body) {
+  response.code = code;
+  response.contentType = contentType ? contentType : "";
+  response.body = body;
+}
+
+void WebServer::send_P(int code, const char* contentType, const char* body, size_t len) {
+  response.code = code;
+  response.contentType = contentType ? contentType : "";
+  response.body = String();
+  response.body.concat(body, static_cast<unsigned>(len));
+}
+
+HostHttpResponse WebServer::request(const char* uri, const char* query) {
+  args.clear();
+  std::string rest = query ? query : "";
+  while (!rest.empty()) {
+    size_t amp = rest.find('&');
+    std::string pair = rest.substr(0, amp);
+    size_t eq = pair.find('=');
+    if (!pair.empty()) args[pair.substr(0, eq)] = eq == std::string::npos ? "" : pair.substr(eq + 1);
+    rest = amp == std::string::npos ? "" : rest.substr(amp + 1);
+  }
+  currentUri = uri;
+  response = HostHttpResponse();
+  auto route = routes.find(uri);
+  if (route != routes.end()) {
+    route->second();
+  } else if (notFound) {
+    notFound();
+  } else {
+    send(404, "text/plain", "Not found");
+  }
+  return response;
+}
+
+HostHttpResponse hostHttpRequest(const char* uri, const char* query) {
+  if (!activeServer) return HostHttpResponse();
+  return activeServer->request(uri, query);
+}
@@ -0,0 +1,152 @@
+#include "WiFi.h"
+#include "host_internal.h"
+#include <vector>
+
+WiFiClass WiFi;
+
+struct EventHandler {
+  WiFiEventCb simple;
+  WiFiEventFuncCb full;
+  WiFiEvent_t event;
+};
+
+static std::vector<EventHandler> handlers;
+static uint8_t fakeBssid[6] = {0x24, 0x0A, 0xC4, 0x12, 0x34, 0x56};
+static const int32_t FAKE_CHANNEL = 6;
+static wifi_config_t staConfig = {};
+static wifi_ps_type_t powerSave = WIFI_PS_MIN_MODEM;
+
+String IPAddress::toString() const {
+  char text[16];
+  snprintf(text, sizeof(text), "%u.%u.%u.%u", octets[0], octets[1], octets[2], octets[3]);
+  return String(text);
+}
+
+// Обробники подій на залізі крутяться в задачі подій; тут - у момент події
+void WiFiClass::emit(WiFiEvent_t event) {
+  WiFiEventInfo_t info = {};
+  for (const EventHandler& handler : handlers) {
+    if (handler.event != ARDUINO_EVENT_MAX && handler.event != event) continue;
+    if (handler.simple) handler.simple(event);
+    if (handler.full) handler.full(event, info);
+  }
+}
+
+void WiFiClass::startConnect(bool cached) {
+  dropLink();
+  currentStatus = WL_DISCONNECTED;
+  if (!host->config.wifiAvailable) return;
+  uint32_t connectMs = cached ? host->config.wifiCachedConnectMs : host->config.wifiConnectMs;
+  connectEvent = hostScheduleEvent(static_cast<int64_t>(connectMs) * 1000LL, [this]() {
+    connectEvent = 0;
+    currentStatus = WL_CONNECTED;
+    hostNoteWifiConnect();
+    emit(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    emit(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+    hostSntpOnConnect();
+  });
+}
+
+void WiFiClass::dropLink() {
+  if (connectEvent) hostCancelEvent(connectEvent);
+  connectEvent = 0;
+  if (currentStatus == WL_CONNECTED) {
+    currentStatus = WL_DISCONNECTED;
+    hostNoteWifiDown();
+    emit(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  }
+}
+
+bool WiFiClass::mode(wifi_mode_t mode) {
+  if (mode == WIFI_OFF || mode == WIFI_AP) dropLink();
+  currentMode = mode;
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* password, int32_t channel, const uint8_t* bssid,
+                             bool connect) {
+  (void)password;
+  (void)channel;
+  if (!ssid || !ssid[0]) return WL_NO_SSID_AVAIL;
+  if (currentMode == WIFI_OFF) currentMode = WIFI_STA;
+  if (connect) startConnect(bssid != nullptr);
+  return currentStatus;
+}
+
+bool WiFiClass::reconnect() {
+  startConnect(false);
+  return true;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+  (void)eraseAp;
+  dropLink();
+  if (wifiOff) currentMode = WIFI_OFF;
+  return true;
+}
+
+IPAddress WiFiClass::localIP() {
+  return currentStatus == WL_CONNECTED ? IPAddress(192, 168, 1, 77) : IPAddress();
+}
+
+uint8_t* WiFiClass::BSSID() {
+  return currentStatus == WL_CONNECTED ? fakeBssid : nullptr;
+}
+
+int32_t WiFiClass::channel() {
+  return currentStatus == WL_CONNECTED ? FAKE_CHANNEL : 0;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* password) {
+  (void)ssid;
+  (void)password;
+  currentMode = currentMode == WIFI_STA ? WIFI_AP_STA : WIFI_AP;
+  return true;
+}
+
+bool WiFiClass::softAPdisconnect(bool wifiOff) {
+  if (wifiOff) currentMode = WIFI_OFF;
+  return true;
+}
+
+int WiFiClass::onEvent(WiFiEventCb callback, WiFiEvent_t event) {
+  handlers.push_back({callback, nullptr, event});
+  return static_cast<int>(handlers.size());
+}
+
+int WiFiClass::onEvent(WiFiEventFuncCb callback, WiFiEvent_t event) {
+  handlers.push_back({nullptr, callback, event});
+  return static_cast<int>(handlers.size());
+}
+
+// === esp_wifi ===
+esp_err_t esp_wifi_set_ps(wifi_ps_type_t type) {
+  powerSave = type;
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_ps(wifi_ps_type_t* type) {
+  if (!type) return ESP_ERR_INVALID_ARG;
+  *type = powerSave;
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t* config) {
+  if (interface != WIFI_IF_STA || !config) return ESP_ERR_INVALID_ARG;
+  *config = staConfig;
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_config(wifi_interface_t interface, wifi_config_t* config) {
+  if (interface != WIFI_IF_STA || !config) return ESP_ERR_INVALID_ARG;
+  staConfig = *config;
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_start() {
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_stop() {
+  return ESP_OK;
+}
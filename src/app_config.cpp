@@ -0,0 +1,160 @@
+#include "app_config.h"
+#include "feed_catchup.h"
+#include "feed_schedule.h"
+#include "wifi_power.h"
+#include <stddef.h>
+
+static const uint8_t APP_CONFIG_VERSION = 3;
+// Старші версії - префікс блоба: версія 1 без полів з drainMa, версія 2 - з idle
+static const size_t APP_CONFIG_V1_SIZE = offsetof(AppConfig, drainMa);
+static const size_t APP_CONFIG_V2_SIZE = offsetof(AppConfig, idle);
+
+// ESP32-C3 + MG996R на 2S: типові значення, уточнюються через /api/setPowerCurrent
+static const uint16_t DEFAULT_POWER_MA[POWER_STATE_COUNT] = {
+  45,    // idle: CPU 160 МГц, Wi-Fi у modem sleep
+  110,   // wifi-connect: сканування + асоціація + DHCP
+  85,    // http: прийом/відправка відповіді
+  950,   // servo: рух під навантаженням + сама плата
+  2,     // light sleep: чип ~0.13 мА, решта - стабілізатор і дільник
+  22,    // idle без радіо: лише CPU
+};
+
+// Окремий блоб "powerMa" до версії 2 конфігурації
+static const uint8_t LEGACY_POWER_TABLE_VERSION = 2;
+struct LegacyPowerTable {
+  uint8_t version;
+  uint16_t ma[POWER_STATE_COUNT];
+};
+
+// Окремі блоби "idleCfg" і "wifiDuty" до версії 3 конфігурації
+static const uint8_t LEGACY_IDLE_VERSION = 1;
+struct LegacyIdleConfig {
+  uint8_t version;
+  uint32_t modemAfterS;
+  uint32_t lightAfterS;
+  uint32_t deepAfterS;
+  uint32_t deepMinLeadS;
+};
+
+static const uint8_t LEGACY_WIFI_DUTY_VERSION = 1;
+struct LegacyWifiDutyConfig {
+  uint8_t version;
+  uint8_t enabled;
+  uint16_t feedLeadS;
+  uint16_t feedAfterS;
+  uint16_t checkInMin;
+  uint16_t checkInS;
+};
+
+AppConfig appConfig = {};
+
+static void loadDefaults() {
+  appConfig = {};
+  appConfig.version = APP_CONFIG_VERSION;
+  appConfig.powerSaveMode = 1;
+  appConfig.catchupPolicy = CATCHUP_ONCE;
+  appConfig.wifiProfile = WIFI_POWER_BALANCED;
+  appConfig.feedRepeats = 1;
+  appConfig.catchupGraceMin = 120;
+  appConfig.stallHoldMs = 60;
+  appConfig.servoSettleMs = 500;
+  appConfig.historyIntervalS = 600;
+  appConfig.speed = 20.0f;
+  appConfig.stallMa = 1500.0f;
+  appConfig.batteryCapacityMah = 2600.0f;
+  snprintf(appConfig.tzName, sizeof(appConfig.tzName), "%s", "Europe/Kyiv");
+  appConfig.drainMa = -1.0f;
+  for (int i = 0; i < POWER_STATE_COUNT; ++i) appConfig.powerMa[i] = DEFAULT_POWER_MA[i];
+  appConfig.idle = {30, static_cast<uint32_t>(ACTIVITY_TIMEOUT / 1000), 1800, 1200};
+  appConfig.wifiDuty = {0, 120, 300, 60, 120};
+}
+
+// Один раз: окремі ключі старих прошивок переносимо в блоб і видаляємо
+static void migrateLegacy(Preferences& preferences) {
+  loadDefaults();
+  appConfig.speed = preferences.getFloat("speed", appConfig.speed);
+  appConfig.servoSettleMs = preferences.getUInt("servoSettleMs", appConfig.servoSettleMs);
+  appConfig.feedRepeats = preferences.getInt("feedRepeats", appConfig.feedRepeats);
+  appConfig.powerSaveMode = preferences.getBool("powerSaveMode", appConfig.powerSaveMode);
+  appConfig.catchupPolicy = preferences.getUChar("catchPolicy", appConfig.catchupPolicy);
+  appConfig.catchupGraceMin = preferences.getUShort("catchGraceMin", appConfig.catchupGraceMin);
+  appConfig.wifiProfile = preferences.getUChar("wifiProfile", appConfig.wifiProfile);
+  appConfig.stallMa = preferences.getFloat("stallMa", appConfig.stallMa);
+  appConfig.stallHoldMs = preferences.getUInt("stallHoldMs", appConfig.stallHoldMs);
+  appConfig.batteryCapacityMah = preferences.getFloat("battCapMah", appConfig.batteryCapacityMah);
+  appConfig.historyIntervalS = preferences.getUInt("histIntervalS", appConfig.historyIntervalS);
+  String tz = preferences.getString("tzName", appConfig.tzName);
+  snprintf(appConfig.tzName, sizeof(appConfig.tzName), "%s", tz.c_str());
+
+  static const char* const LEGACY_KEYS[] = {
+    "speed", "servoSettleMs", "feedRepeats", "powerSaveMode", "catchPolicy", "catchGraceMin",
+    "wifiProfile", "stallMa", "stallHoldMs", "battCapMah", "histIntervalS", "tzName"
+  };
+  for (const char* key : LEGACY_KEYS) preferences.remove(key);
+  // Розклад уже в блобі - старі ключі двох годувань більше не потрібні.
+  // Без блоба їх прочитає і видалить scheduleLoad()
+  if (preferences.isKey("schedule")) scheduleRemoveLegacyKeys(preferences);
+  Serial.println("Config migrated to a single blob");
+}
+
+// Версія 2: виміряний струм і таблиця струмів переїхали в блоб з окремих ключів
+static void migrateSeparateKeys(Preferences& preferences) {
+  appConfig.drainMa = preferences.getFloat("drainMa", appConfig.drainMa);
+  LegacyPowerTable table = {};
+  size_t len = preferences.getBytes("powerMa", &table, sizeof(table));
+  if (len == sizeof(table) && table.version == LEGACY_POWER_TABLE_VERSION) {
+    for (int i = 0; i < POWER_STATE_COUNT; ++i) appConfig.powerMa[i] = table.ma[i];
+  }
+  preferences.remove("drainMa");
+  preferences.remove("powerMa");
+}
+
+// Версія 3: пороги сну і вікна Wi-Fi переїхали в блоб з власних блобів модулів.
+// "idleCfg" найстаріших прошивок - ті самі поля без байта версії
+static void migrateModuleBlobs(Preferences& preferences) {
+  LegacyIdleConfig idle = {};
+  size_t len = preferences.getBytes("idleCfg", &idle, sizeof(idle));
+  if (len == sizeof(idle) && idle.version == LEGACY_IDLE_VERSION) {
+    appConfig.idle = {idle.modemAfterS, idle.lightAfterS, idle.deepAfterS, idle.deepMinLeadS};
+  } else if (len == sizeof(IdleGovernorConfig)) {
+    preferences.getBytes("idleCfg", &appConfig.idle, sizeof(appConfig.idle));
+  }
+  LegacyWifiDutyConfig duty = {};
+  len = preferences.getBytes("wifiDuty", &duty, sizeof(duty));
+  if (len == sizeof(duty) && duty.version == LEGACY_WIFI_DUTY_VERSION) {
+    appConfig.wifiDuty = {duty.enabled, duty.feedLeadS, duty.feedAfterS, duty.checkInMin, duty.checkInS};
+  }
+  preferences.remove("idleCfg");
+  preferences.remove("wifiDuty");
+}
+
+void appConfigLoad(Preferences& preferences) {
+  AppConfig stored = {};
+  size_t len = preferences.getBytes("config", &stored, sizeof(stored));
+  if (len == sizeof(stored) && stored.version == APP_CONFIG_VERSION) {
+    appConfig = stored;
+    appConfig.tzName[APP_CONFIG_TZ_LEN - 1] = '\0';
+    return;
+  }
+  if (len == APP_CONFIG_V2_SIZE && stored.version == 2) {
+    loadDefaults();
+    memcpy(&appConfig, &stored, APP_CONFIG_V2_SIZE);
+    appConfig.tzName[APP_CONFIG_TZ_LEN - 1] = '\0';
+  } else {
+    if (len == APP_CONFIG_V1_SIZE && stored.version == 1) {
+      loadDefaults();
+      memcpy(&appConfig, &stored, APP_CONFIG_V1_SIZE);
+      appConfig.tzName[APP_CONFIG_TZ_LEN - 1] = '\0';
+    } else {
+      migrateLegacy(preferences);
+    }
+    migrateSeparateKeys(preferences);
+  }
+  migrateModuleBlobs(preferences);
+  appConfigSave(preferences);
+}
+
+void appConfigSave(Preferences& preferences) {
+  appConfig.version = APP_CONFIG_VERSION;
+  preferences.putBytes("config", &appConfig, sizeof(appConfig));
+}
@@ -0,0 +1,47 @@
+#ifndef APP_CONFIG_H
+#define APP_CONFIG_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "power_profile.h"
+#include "idle_governor.h"
+#include "wifi_duty.h"
+
+// === App config ===
+// Скалярні налаштування одним блобом "config": при старті одне читання NVS
+// замість ключа на кожне поле. Модулі беруть значення з appConfig у своїх
+// *Begin(), сеттери змінюють поле і викликають appConfigSave(). Блоби з
+// власною версією (розклад, калібрування тощо) окремі. Нові поля - лише в
+// кінець структури: старіша версія блоба тоді є її префіксом.
+#define APP_CONFIG_TZ_LEN 24
+
+struct AppConfig {
+  uint8_t version;
+  uint8_t powerSaveMode;
+  uint8_t catchupPolicy;
+  uint8_t wifiProfile;
+  int16_t feedRepeats;          // повтори ручного годування
+  uint16_t catchupGraceMin;
+  uint16_t stallHoldMs;
+  uint16_t reserved;
+  uint32_t servoSettleMs;
+  uint32_t historyIntervalS;
+  float speed;
+  float stallMa;
+  float batteryCapacityMah;
+  char tzName[APP_CONFIG_TZ_LEN];
+  // Версія 2: колись окремі ключі "drainMa" і "powerMa"
+  float drainMa;                        // виміряний фоновий струм, -1 - ще не виміряно
+  uint16_t powerMa[POWER_STATE_COUNT];  // оцінка струму всієї плати в кожному стані
+  // Версія 3: колись окремі блоби "idleCfg" і "wifiDuty"
+  IdleGovernorConfig idle;
+  WifiDutyConfig wifiDuty;
+};
+
+extern AppConfig appConfig;
+
+// === App Config Functions ===
+void appConfigLoad(Preferences& preferences);
+void appConfigSave(Preferences& preferences);
+
+#endif
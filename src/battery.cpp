@@ -0,0 +1,74 @@
+#include "battery.h"
+#include "esp_adc_cal.h"
+#include "servo_motion.h"
+#include "speed_model.h"
+#include "current_sense.h"
+
+// === Battery ===
+uint32_t batteryMillivolts = 0;
+uint32_t batteryCentiPercent = 0;
+const int BATTERY_SAMPLES = 16;
+const uint32_t VOLTAGE_DIVIDER_RATIO_X100 = 508;     // 5.08, розраховано під MH Electronic сенсор
+const uint32_t BATTERY_CALIBRATION_PERMILLE = 1000;  // лише допуск резисторів дільника; АЦП калібрується з eFuse
+const uint32_t BATTERY_INTERNAL_RESISTANCE_MOHM = 150; // 2S пакет + проводка
+
+static int batteryPin = -1;
+static esp_adc_cal_characteristics_t adcChars;
+static esp_adc_cal_value_t adcCalSource = ESP_ADC_CAL_VAL_DEFAULT_VREF;
+
+void configureBatteryAdc(int pin) {
+  batteryPin = pin;
+#if defined(ESP32) || defined(ARDUINO_ARCH_ESP32) || defined(CONFIG_IDF_TARGET_ESP32C3) || defined(CONFIG_IDF_TARGET_ESP32S3)
+  analogReadResolution(12);
+  analogSetAttenuation(ADC_11db);
+  adcCalSource = esp_adc_cal_characterize(ADC_UNIT_1, ADC_ATTEN_DB_11, ADC_WIDTH_BIT_12, 1100, &adcChars);
+#endif
+}
+
+const char* batteryAdcCalibrationName() {
+  switch (adcCalSource) {
+    case ESP_ADC_CAL_VAL_EFUSE_VREF: return "efuse_vref";
+    case ESP_ADC_CAL_VAL_EFUSE_TP: return "efuse_tp";
+    case ESP_ADC_CAL_VAL_EFUSE_TP_FIT: return "efuse_tp_fit";
+    default: return "default_vref";
+  }
+}
+
+// === Utilities ===
+// Без округлення до мВ: його робить лише кінцевий крок (формат, відсоток)
+uint32_t readBatteryUnits() {
+  uint32_t accumulator = 0;
+  for (int i = 0; i < BATTERY_SAMPLES; ++i) {
+    accumulator += analogRead(batteryPin);
+    delayMicroseconds(200);
+  }
+  uint32_t raw = (accumulator + BATTERY_SAMPLES / 2) / BATTERY_SAMPLES;
+  uint32_t pinMv = esp_adc_cal_raw_to_voltage(raw, &adcChars);
+  return batteryPinToUnits(pinMv, VOLTAGE_DIVIDER_RATIO_X100, BATTERY_CALIBRATION_PERMILLE);
+}
+
+uint32_t readBatteryMillivolts() {
+  return batteryUnitsToMillivolts(readBatteryUnits());
+}
+
+// Струм, що просаджує напругу пакета через серво (для компенсації під навантаженням)
+uint32_t batteryLoadCurrentMa() {
+  if (motionIsMoving()) {
+    return currentSenseAvailable() ? currentSenseReadMa() : SERVO_MOVING_CURRENT_MA;
+  }
+  if (motionIsAttached()) return SERVO_HOLD_CURRENT_MA;
+  return 0;
+}
+
+uint32_t batteryCentiPercentFromUnits(uint32_t units) {
+  return batteryUnitsToCentiPercent(units, batteryLoadCurrentMa(), BATTERY_INTERNAL_RESISTANCE_MOHM);
+}
+
+uint32_t batteryPercentFromUnits(uint32_t units) {
+  return batteryUnitsToPercent(units, batteryLoadCurrentMa(), BATTERY_INTERNAL_RESISTANCE_MOHM);
+}
+
+// Записи історії зберігають лише цілі мВ
+uint32_t millivoltsToCentiPercent(uint32_t mv) {
+  return batteryCentiPercentFromUnits(mv * BATTERY_UNITS_PER_MV);
+}
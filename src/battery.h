@@ -0,0 +1,26 @@
+#ifndef BATTERY_H
+#define BATTERY_H
+
+#include <Arduino.h>
+#include "battery_convert.h"
+
+// === Battery ===
+// Уся арифметика цілочисельна (мВ, мА, соті відсотка): у ESP32-C3 немає FPU
+extern uint32_t batteryMillivolts;
+extern uint32_t batteryCentiPercent;
+extern const int BATTERY_SAMPLES;
+extern const uint32_t VOLTAGE_DIVIDER_RATIO_X100;
+extern const uint32_t BATTERY_CALIBRATION_PERMILLE;
+extern const uint32_t BATTERY_INTERNAL_RESISTANCE_MOHM;
+
+// === Battery Functions ===
+void configureBatteryAdc(int pin);
+const char* batteryAdcCalibrationName();
+uint32_t readBatteryUnits();
+uint32_t readBatteryMillivolts();
+uint32_t batteryLoadCurrentMa();
+uint32_t batteryCentiPercentFromUnits(uint32_t units);
+uint32_t batteryPercentFromUnits(uint32_t units);
+uint32_t millivoltsToCentiPercent(uint32_t mv);
+
+#endif
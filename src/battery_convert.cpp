@@ -0,0 +1,78 @@
+#include "battery_convert.h"
+
+// Крива напруги розімкненого кола 2S Li-Ion (мВ пакета -> %), за зростанням напруги
+struct OcvPoint {
+  uint16_t mv;
+  uint8_t percent;
+};
+
+static constexpr OcvPoint OCV_CURVE[] = {
+  {6600, 0},  {7000, 3},  {7220, 5},  {7380, 10}, {7460, 20},
+  {7540, 30}, {7600, 40}, {7680, 50}, {7740, 60}, {7900, 70},
+  {8040, 80}, {8160, 85}, {8220, 90}, {8300, 95}, {8400, 100},
+};
+static constexpr int OCV_POINTS = sizeof(OCV_CURVE) / sizeof(OCV_CURVE[0]);
+
+// Округлення половини вгору, як у dtostrf() ядра, через яке друкував String(float)
+static uint32_t roundedDiv(uint64_t num, uint64_t den) {
+  return static_cast<uint32_t>((num + den / 2) / den);
+}
+
+// pinMv <= ~3300, тож добуток для дільника 5.08 і калібрування ~1.0 вміщується в uint32_t
+uint32_t batteryPinToUnits(uint32_t pinMv, uint32_t dividerRatioX100, uint32_t calibrationPermille) {
+  return pinMv * dividerRatioX100 * calibrationPermille;
+}
+
+uint32_t batteryUnitsToMillivolts(uint32_t units) {
+  return roundedDiv(units, BATTERY_UNITS_PER_MV);
+}
+
+// Відсоток x scale з одним округленням: V_ocv = V + I * R, далі інтерполяція кривої.
+// мА x мОм = мкВ = 100 одиниць
+static uint32_t ocvToScaledPercent(uint32_t units, uint32_t loadMa, uint32_t resistanceMohm, uint32_t scale) {
+  uint64_t ocv = static_cast<uint64_t>(units) + static_cast<uint64_t>(loadMa) * resistanceMohm * 100U;
+
+  if (ocv <= OCV_CURVE[0].mv * BATTERY_UNITS_PER_MV) return 0;
+  if (ocv >= OCV_CURVE[OCV_POINTS - 1].mv * BATTERY_UNITS_PER_MV) return 100U * scale;
+  for (int i = 1; i < OCV_POINTS; ++i) {
+    if (ocv <= OCV_CURVE[i].mv * BATTERY_UNITS_PER_MV) {
+      const OcvPoint& lo = OCV_CURVE[i - 1];
+      const OcvPoint& hi = OCV_CURVE[i];
+      uint64_t span = static_cast<uint64_t>(hi.mv - lo.mv) * BATTERY_UNITS_PER_MV;
+      uint64_t rise = static_cast<uint64_t>(hi.percent - lo.percent) * scale;
+      return lo.percent * scale + roundedDiv((ocv - lo.mv * BATTERY_UNITS_PER_MV) * rise, span);
+    }
+  }
+  return 100U * scale;
+}
+
+uint32_t batteryUnitsToCentiPercent(uint32_t units, uint32_t loadMa, uint32_t resistanceMohm) {
+  return ocvToScaledPercent(units, loadMa, resistanceMohm, 100);
+}
+
+// Цілий відсоток для /api/status - те саме, що String(percent, 0)
+uint32_t batteryUnitsToPercent(uint32_t units, uint32_t loadMa, uint32_t resistanceMohm) {
+  return ocvToScaledPercent(units, loadMa, resistanceMohm, 1);
+}
+
+// "8.40" - те саме, що String(v, 2) для напруги у вольтах. Цифри вручну:
+// printf з newlib на цьому шляху дорожчий за саму арифметику
+void formatBatteryVolts(uint32_t units, char* buf, size_t len) {
+  uint32_t centivolts = roundedDiv(units, BATTERY_UNITS_PER_MV * 10);
+  char digits[12];
+  size_t n = 0;
+  do {
+    digits[n++] = static_cast<char>('0' + centivolts % 10);
+    centivolts /= 10;
+  } while (centivolts > 0 || n < 3);
+  if (len < n + 2) {
+    if (len > 0) buf[0] = '\0';
+    return;
+  }
+  size_t out = 0;
+  while (n > 2) buf[out++] = digits[--n];
+  buf[out++] = '.';
+  buf[out++] = digits[1];
+  buf[out++] = digits[0];
+  buf[out] = '\0';
+}
@@ -0,0 +1,21 @@
+#ifndef BATTERY_CONVERT_H
+#define BATTERY_CONVERT_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+// === Battery conversions ===
+// Чиста цілочисельна логіка без залежностей від Arduino: перевіряється на хості
+// (test/test_battery_convert). Напруга пакета - в одиницях 10 нВ (мВ x 100000),
+// тобто добуток показу піна на дільник і калібрування без ділення. Округлюється
+// лише кінцеве значення, як у колишньому String(v, 2) від float.
+#define BATTERY_UNITS_PER_MV 100000UL
+
+// === Battery Conversion Functions ===
+uint32_t batteryPinToUnits(uint32_t pinMv, uint32_t dividerRatioX100, uint32_t calibrationPermille);
+uint32_t batteryUnitsToMillivolts(uint32_t units);
+uint32_t batteryUnitsToCentiPercent(uint32_t units, uint32_t loadMa, uint32_t resistanceMohm);
+uint32_t batteryUnitsToPercent(uint32_t units, uint32_t loadMa, uint32_t resistanceMohm);
+void formatBatteryVolts(uint32_t units, char* buf, size_t len);
+
+#endif
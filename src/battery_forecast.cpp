@@ -0,0 +1,117 @@
+#include "battery_forecast.h"
+#include "battery.h"
+#include "power_profile.h"
+#include "app_config.h"
+
+// === Battery forecast ===
+float batteryCapacityMah = 2600.0f;          // 2S 18650
+const float WAKE_COST_MAH = 0.05f;           // вихід зі сну + перевірки до засинання
+const float WIFI_SESSION_COST_MAH = 0.8f;    // асоціація + DHCP + SNTP (~4 с по ~200 мА)
+
+static const uint32_t FORECAST_MIN_WINDOW_S = 3600; // SoC з напруги шумний, беремо вікна від години
+static const uint32_t FORECAST_MAX_GAP_SAMPLES = 4;  // довше вікно - стрибок годинника, а не вимір
+static const uint32_t FORECAST_MAX_SLEEP_S = 86400;  // крізь deep sleep пауза між записами - сам сон
+static const uint32_t FORECAST_MAGIC = 0xF0CA0001;
+static const float FORECAST_EMA_ALPHA = 0.2f;
+
+static Preferences* forecastPreferences = nullptr;
+static float measuredDrainMa = -1.0f;
+static float feedMahPerDay = 0.0f;
+static int wakesPerDay = 0;
+static int feedWifiSessionsPerDay = 0;
+static int checkInSessionsPerDay = 0;
+
+// Якір переживає deep sleep, як і сама історія: інакше вікно від години
+// не завершується, коли плата прокидається лише на годування і check-in
+static RTC_DATA_ATTR uint32_t forecastMagic;
+static RTC_DATA_ATTR bool anchorValid;
+static RTC_DATA_ATTR bool anchorTimeValid;
+static RTC_DATA_ATTR uint32_t anchorT;
+static RTC_DATA_ATTR float anchorPercent;
+static RTC_DATA_ATTR bool windowHadServo;
+
+void batteryForecastBegin(Preferences& preferences) {
+  forecastPreferences = &preferences;
+  batteryCapacityMah = appConfig.batteryCapacityMah;
+  measuredDrainMa = appConfig.drainMa;
+  if (forecastMagic != FORECAST_MAGIC) {
+    // Холодний старт: вміст RTC RAM невизначений
+    forecastMagic = FORECAST_MAGIC;
+    anchorValid = false;
+    windowHadServo = false;
+  }
+}
+
+void batteryForecastSetCapacity(float mah, Preferences& preferences) {
+  batteryCapacityMah = constrain(mah, 100.0f, 20000.0f);
+  appConfig.batteryCapacityMah = batteryCapacityMah;
+  appConfigSave(preferences);
+}
+
+// Викликається при зміні розкладу, а не на кожен запит
+void batteryForecastSetSchedule(float feedMah, int wakes, int feedWifiSessions, int checkInSessions) {
+  feedMahPerDay = feedMah;
+  wakesPerDay = wakes;
+  feedWifiSessionsPerDay = feedWifiSessions;
+  checkInSessionsPerDay = checkInSessions;
+}
+
+// Інкрементально: один новий запис історії -> оновлення EMA фонового споживання.
+// Вікна зі ходами серво пропускаємо - їх вартість рахується моделлю розкладу.
+void batteryForecastOnSample(const BatteryHistoryRecord& record) {
+  float percent = millivoltsToCentiPercent(record.mv) / 100.0f;
+  if (record.flags & HISTORY_SERVO_ACTIVE) windowHadServo = true;
+
+  // Якір скидається при стрибку годинника: SNTP переводить t з часу від старту
+  // в UNIX-час (+1.7e9 с), корекція назад або пропуск багатьох записів.
+  // Після сну з дійсним часом довга пауза - сам сон, а не стрибок
+  const bool timeValid = record.flags & HISTORY_TIME_VALID;
+  const bool slept = timeValid && (record.flags & HISTORY_SLEPT);
+  const uint32_t maxWindow = FORECAST_MIN_WINDOW_S +
+                             (slept ? FORECAST_MAX_SLEEP_S : FORECAST_MAX_GAP_SAMPLES * batteryHistoryIntervalS);
+  if (!anchorValid || timeValid != anchorTimeValid || record.t < anchorT || record.t - anchorT > maxWindow) {
+    anchorValid = true;
+    anchorTimeValid = timeValid;
+    anchorT = record.t;
+    anchorPercent = percent;
+    windowHadServo = false;
+    return;
+  }
+
+  uint32_t window = record.t - anchorT;
+  if (window < FORECAST_MIN_WINDOW_S) return;
+
+  if (!windowHadServo && percent <= anchorPercent) {
+    float usedMah = (anchorPercent - percent) / 100.0f * batteryCapacityMah;
+    float drainMa = usedMah / (window / 3600.0f);
+    measuredDrainMa = measuredDrainMa < 0.0f
+      ? drainMa
+      : measuredDrainMa + FORECAST_EMA_ALPHA * (drainMa - measuredDrainMa);
+    // Не частіше раза на годину - ресурс NVS не страждає
+    appConfig.drainMa = measuredDrainMa;
+    if (forecastPreferences) appConfigSave(*forecastPreferences);
+  }
+
+  anchorT = record.t;
+  anchorPercent = percent;
+  windowHadServo = false;
+}
+
+BatteryForecast batteryForecastCompute(uint32_t batteryCentiPercent) {
+  BatteryForecast f;
+  f.measuredDrainMa = measuredDrainMa;
+  f.feedMahPerDay = feedMahPerDay;
+  // Пробудження і вікна Wi-Fi до годувань потрапляють у вікна з серво, які вимір
+  // пропускає, тож їх додаємо завжди. Сеанси перевірки зв'язку виміряний струм
+  // уже містить - модель для них лише до першого виміру
+  const bool measured = measuredDrainMa >= 0.0f;
+  int wifiSessions = feedWifiSessionsPerDay + (measured ? 0 : checkInSessionsPerDay);
+  f.wakeMahPerDay = wakesPerDay * WAKE_COST_MAH;
+  f.wifiMahPerDay = wifiSessions * WIFI_SESSION_COST_MAH;
+  // До першого виміру - модельний струм простою з таблиці станів
+  float baseMa = measured ? measuredDrainMa : powerStateCurrentMa(POWER_IDLE);
+  f.dailyMah = baseMa * 24.0f + f.feedMahPerDay + f.wakeMahPerDay + f.wifiMahPerDay;
+  f.remainingMah = min(batteryCentiPercent, static_cast<uint32_t>(10000)) / 10000.0f * batteryCapacityMah;
+  f.daysRemaining = f.dailyMah > 0.0f ? f.remainingMah / f.dailyMah : -1.0f;
+  return f;
+}
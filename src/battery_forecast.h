@@ -0,0 +1,31 @@
+#ifndef BATTERY_FORECAST_H
+#define BATTERY_FORECAST_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "battery_history.h"
+
+// === Battery forecast ===
+extern float batteryCapacityMah;
+extern const float WAKE_COST_MAH;
+extern const float WIFI_SESSION_COST_MAH;
+
+struct BatteryForecast {
+  float measuredDrainMa;    // фонове споживання з історії (без ходів серво), <0 - ще не виміряно
+  float feedMahPerDay;      // серво за розкладом
+  float wakeMahPerDay;      // пробудження до годувань
+  float wifiMahPerDay;      // сесії Wi-Fi поза виміряним струмом
+  float dailyMah;
+  float remainingMah;
+  float daysRemaining;
+};
+
+// === Forecast Functions ===
+void batteryForecastBegin(Preferences& preferences);
+void batteryForecastSetCapacity(float mah, Preferences& preferences);
+void batteryForecastSetSchedule(float feedMahPerDay, int wakesPerDay, int feedWifiSessionsPerDay,
+                                int checkInSessionsPerDay);
+void batteryForecastOnSample(const BatteryHistoryRecord& record);
+BatteryForecast batteryForecastCompute(uint32_t batteryCentiPercent);
+
+#endif
@@ -0,0 +1,152 @@
+#include "battery_history.h"
+#include "battery.h"
+#include "battery_forecast.h"
+#include "app_config.h"
+#include "time.h"
+
+static const uint32_t HISTORY_MAGIC = 0xB4770001;
+
+// === Battery history ===
+static RTC_DATA_ATTR uint32_t historyMagic;
+static RTC_DATA_ATTR uint16_t historyHead;
+static RTC_DATA_ATTR uint16_t historyCount;
+static RTC_DATA_ATTR uint8_t historyPendingFlags;
+static RTC_DATA_ATTR uint32_t historyLastSampleT;
+static RTC_DATA_ATTR BatteryHistoryRecord historyRing[BATTERY_HISTORY_CAPACITY];
+
+uint32_t batteryHistoryIntervalS = 600;
+
+void batteryHistoryBegin() {
+  batteryHistoryIntervalS = appConfig.historyIntervalS;
+  if (historyMagic != HISTORY_MAGIC) {
+    // Холодний старт: вміст RTC RAM невизначений
+    historyMagic = HISTORY_MAGIC;
+    historyHead = 0;
+    historyCount = 0;
+    historyPendingFlags = 0;
+    historyLastSampleT = 0;
+  }
+}
+
+void batteryHistorySetInterval(uint32_t seconds, Preferences& preferences) {
+  batteryHistoryIntervalS = constrain(seconds, 10UL, 86400UL);
+  appConfig.historyIntervalS = batteryHistoryIntervalS;
+  appConfigSave(preferences);
+}
+
+void batteryHistoryMark(uint8_t flags) {
+  historyPendingFlags |= flags;
+}
+
+// Час з RTC (time()) не скидається у сні, тож інтервал коректний і після пробудження
+void batteryHistoryTick() {
+  uint32_t now = static_cast<uint32_t>(time(nullptr));
+  if (historyCount > 0 && now - historyLastSampleT < batteryHistoryIntervalS) return;
+
+  BatteryHistoryRecord& rec = historyRing[historyHead];
+  rec.t = now;
+  rec.mv = static_cast<uint16_t>(min(readBatteryMillivolts(), static_cast<uint32_t>(65535)));
+  rec.flags = historyPendingFlags;
+  if (now > 1577836800UL) rec.flags |= HISTORY_TIME_VALID;
+  rec.reserved = 0;
+
+  historyHead = (historyHead + 1) % BATTERY_HISTORY_CAPACITY;
+  if (historyCount < BATTERY_HISTORY_CAPACITY) historyCount++;
+  historyPendingFlags = 0;
+  historyLastSampleT = now;
+  batteryForecastOnSample(rec);
+}
+
+int batteryHistoryCount() {
+  return historyCount;
+}
+
+// index 0 - найстаріший запис
+const BatteryHistoryRecord& batteryHistoryAt(int index) {
+  int start = (historyHead - historyCount + BATTERY_HISTORY_CAPACITY) % BATTERY_HISTORY_CAPACITY;
+  return historyRing[(start + index) % BATTERY_HISTORY_CAPACITY];
+}
+
+// === LTTB downsampling ===
+// Largest-Triangle-Three-Buckets: зберігає форму кривої при малій кількості точок
+static int selectLttb(int count, int threshold, uint16_t* selected) {
+  if (threshold >= count || threshold < 3) {
+    for (int i = 0; i < count; ++i) selected[i] = i;
+    return count;
+  }
+
+  int outCount = 0;
+  selected[outCount++] = 0;
+  const float bucketSize = static_cast<float>(count - 2) / (threshold - 2);
+  int a = 0;
+
+  for (int i = 0; i < threshold - 2; ++i) {
+    int avgStart = static_cast<int>((i + 1) * bucketSize) + 1;
+    int avgEnd = min(static_cast<int>((i + 2) * bucketSize) + 1, count);
+    float avgT = 0.0f;
+    float avgV = 0.0f;
+    for (int j = avgStart; j < avgEnd; ++j) {
+      avgT += batteryHistoryAt(j).t;
+      avgV += batteryHistoryAt(j).mv;
+    }
+    int avgLen = max(avgEnd - avgStart, 1);
+    avgT /= avgLen;
+    avgV /= avgLen;
+
+    int rangeStart = static_cast<int>(i * bucketSize) + 1;
+    int rangeEnd = static_cast<int>((i + 1) * bucketSize) + 1;
+    const float pointT = batteryHistoryAt(a).t;
+    const float pointV = batteryHistoryAt(a).mv;
+    float maxArea = -1.0f;
+    int next = rangeStart;
+    for (int j = rangeStart; j < rangeEnd; ++j) {
+      const BatteryHistoryRecord& r = batteryHistoryAt(j);
+      float area = fabsf((pointT - avgT) * (r.mv - pointV) - (pointT - r.t) * (avgV - pointV));
+      if (area > maxArea) {
+        maxArea = area;
+        next = j;
+      }
+    }
+    selected[outCount++] = next;
+    a = next;
+  }
+
+  selected[outCount++] = count - 1;
+  return outCount;
+}
+
+// === Binary encoding ===
+static size_t putVarint(uint8_t* out, size_t pos, size_t outSize, uint32_t value) {
+  while (pos < outSize) {
+    uint8_t byte = value & 0x7F;
+    value >>= 7;
+    if (value) byte |= 0x80;
+    out[pos++] = byte;
+    if (!value) break;
+  }
+  return pos;
+}
+
+static uint32_t zigzag(int32_t value) {
+  return (static_cast<uint32_t>(value) << 1) ^ static_cast<uint32_t>(value >> 31);
+}
+
+// Формат: varint N, далі N x [zigzag varint Δt, zigzag varint Δмв, байт прапорців].
+// Перша дельта рахується від нуля.
+size_t batteryHistoryEncode(int maxPoints, uint8_t* out, size_t outSize) {
+  static uint16_t selected[BATTERY_HISTORY_CAPACITY];
+  int count = selectLttb(historyCount, maxPoints, selected);
+
+  size_t pos = putVarint(out, 0, outSize, count);
+  uint32_t prevT = 0;
+  uint16_t prevMv = 0;
+  for (int i = 0; i < count && pos < outSize; ++i) {
+    const BatteryHistoryRecord& r = batteryHistoryAt(selected[i]);
+    pos = putVarint(out, pos, outSize, zigzag(static_cast<int32_t>(r.t - prevT)));
+    pos = putVarint(out, pos, outSize, zigzag(static_cast<int32_t>(r.mv) - prevMv));
+    if (pos < outSize) out[pos++] = r.flags;
+    prevT = r.t;
+    prevMv = r.mv;
+  }
+  return pos;
+}
@@ -0,0 +1,35 @@
+#ifndef BATTERY_HISTORY_H
+#define BATTERY_HISTORY_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// === Battery history ===
+// Кільцевий буфер у RTC RAM: переживає light/deep sleep і програмне перезавантаження
+#define BATTERY_HISTORY_CAPACITY 384
+
+enum BatteryHistoryFlags : uint8_t {
+  HISTORY_SERVO_ACTIVE = 0x01,  // серво працювало з попереднього запису
+  HISTORY_SLEPT = 0x02,         // пристрій спав з попереднього запису
+  HISTORY_TIME_VALID = 0x04,    // t - реальний UNIX-час (інакше - час від старту RTC)
+};
+
+struct BatteryHistoryRecord {
+  uint32_t t;
+  uint16_t mv;
+  uint8_t flags;
+  uint8_t reserved;
+};
+
+extern uint32_t batteryHistoryIntervalS;
+
+// === History Functions ===
+void batteryHistoryBegin();
+void batteryHistorySetInterval(uint32_t seconds, Preferences& preferences);
+void batteryHistoryMark(uint8_t flags);
+void batteryHistoryTick();
+int batteryHistoryCount();
+const BatteryHistoryRecord& batteryHistoryAt(int index);
+size_t batteryHistoryEncode(int maxPoints, uint8_t* out, size_t outSize);
+
+#endif
@@ -0,0 +1,66 @@
+#include "boot_profile.h"
+#include <esp_timer.h>
+
+static const char* const PHASE_NAMES[BOOT_PHASE_COUNT] = {
+  "nvs", "wifiStart", "adc", "servo", "config", "wifi", "network", "routes", "server"
+};
+
+static const char* const READY_NAMES[BOOT_READY_COUNT] = {
+  "servo", "config", "http", "wifi", "network", "schedule"
+};
+
+// === Boot profile ===
+static int64_t phaseStartUs[BOOT_PHASE_COUNT];
+static int64_t phaseEndUs[BOOT_PHASE_COUNT];
+static int64_t readyAtUs[BOOT_READY_COUNT];
+static int64_t setupStartUs = 0;
+
+// Першим рядком setup(): до нього лише ROM і завантажувач
+void bootProfileBegin() {
+  setupStartUs = esp_timer_get_time();
+}
+
+void bootPhaseBegin(BootPhase phase) {
+  if (phaseStartUs[phase] == 0) phaseStartUs[phase] = esp_timer_get_time();
+}
+
+void bootPhaseEnd(BootPhase phase) {
+  if (phaseStartUs[phase] != 0 && phaseEndUs[phase] == 0) phaseEndUs[phase] = esp_timer_get_time();
+}
+
+// Дешево для виклику з кожного проходу loop(): записується лише перший раз
+void bootReady(BootReady subsystem) {
+  if (readyAtUs[subsystem] != 0) return;
+  readyAtUs[subsystem] = esp_timer_get_time();
+  Serial.printf("Ready: %s at %lld ms\n", READY_NAMES[subsystem], static_cast<long long>(readyAtUs[subsystem] / 1000));
+}
+
+bool bootIsReady(BootReady subsystem) {
+  return readyAtUs[subsystem] != 0;
+}
+
+// long на ESP32-C3 32-бітний: мікросекунди переповнили б його за ~35 хв
+String bootProfileToJson() {
+  String json = "{";
+  json += "\"setupStartUs\":" + String(static_cast<long long>(setupStartUs)) + ",";
+  // -1: підсистема ще не готова
+  json += "\"readyUs\":{";
+  for (int i = 0; i < BOOT_READY_COUNT; ++i) {
+    if (i > 0) json += ",";
+    json += "\"" + String(READY_NAMES[i]) + "\":" + String(readyAtUs[i] ? static_cast<long long>(readyAtUs[i]) : -1LL);
+  }
+  json += "},";
+  json += "\"phases\":[";
+  bool first = true;
+  for (int i = 0; i < BOOT_PHASE_COUNT; ++i) {
+    if (phaseStartUs[i] == 0) continue;
+    if (!first) json += ",";
+    first = false;
+    json += "{\"name\":\"" + String(PHASE_NAMES[i]) + "\",";
+    json += "\"startUs\":" + String(static_cast<long long>(phaseStartUs[i])) + ",";
+    // -1: фаза ще триває (фонове підключення)
+    json += "\"us\":" + String(phaseEndUs[i] ? static_cast<long long>(phaseEndUs[i] - phaseStartUs[i]) : -1LL) + "}";
+  }
+  json += "]}";
+  return json;
+}
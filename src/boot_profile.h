@@ -0,0 +1,43 @@
+#ifndef BOOT_PROFILE_H
+#define BOOT_PROFILE_H
+
+#include <Arduino.h>
+
+// === Boot profile ===
+// Тривалість кожної фази старту за esp_timer (мкс від старту застосунку)
+// і момент готовності кожної підсистеми. Фази перекриваються: Wi-Fi
+// асоціюється у своїй задачі, поки setup() вантажить налаштування.
+// Фіксується лише перше проходження: повторні підключення у вікнах Wi-Fi
+// не переписують картину завантаження.
+enum BootPhase : uint8_t {
+  BOOT_PHASE_NVS = 0,     // відкриття NVS, appConfig і таблиця струмів
+  BOOT_PHASE_WIFI_START,  // синхронна частина старту Wi-Fi до фонової асоціації
+  BOOT_PHASE_ADC,
+  BOOT_PHASE_SERVO,
+  BOOT_PHASE_CONFIG,
+  BOOT_PHASE_WIFI,
+  BOOT_PHASE_NETWORK,     // mDNS і SNTP після отримання IP
+  BOOT_PHASE_ROUTES,
+  BOOT_PHASE_SERVER,
+  BOOT_PHASE_COUNT
+};
+
+enum BootReady : uint8_t {
+  BOOT_READY_SERVO = 0,
+  BOOT_READY_CONFIG,
+  BOOT_READY_HTTP,
+  BOOT_READY_WIFI,        // є IP
+  BOOT_READY_NETWORK,     // mDNS і SNTP запущено
+  BOOT_READY_SCHEDULE,    // годинник дійсний, розклад виконується
+  BOOT_READY_COUNT
+};
+
+// === Boot Profile Functions ===
+void bootProfileBegin();
+void bootPhaseBegin(BootPhase phase);
+void bootPhaseEnd(BootPhase phase);
+void bootReady(BootReady subsystem);
+bool bootIsReady(BootReady subsystem);
+String bootProfileToJson();
+
+#endif
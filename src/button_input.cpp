@@ -0,0 +1,69 @@
+#include "button_input.h"
+#include "servo_motion.h"
+#include <esp_timer.h>
+#include <esp_sleep.h>
+#include <driver/gpio.h>
+
+const unsigned long BUTTON_DEBOUNCE_US = 30000;
+
+static int buttonPin = -1;
+static esp_timer_handle_t debounceTimer = nullptr;
+static volatile bool debouncePending = false;
+static volatile uint32_t pressCount = 0;
+
+// Таймер виконується в задачі esp_timer, не в перериванні
+static void debounceExpired(void*) {
+  debouncePending = false;
+  if (digitalRead(buttonPin) != LOW) return;
+  pressCount++;
+  motionQueueJob(MOTION_JOB_FEED, MOTION_SOURCE_BUTTON);
+}
+
+static void IRAM_ATTR buttonIsr() {
+  if (debouncePending) return;
+  debouncePending = true;
+  esp_timer_start_once(debounceTimer, BUTTON_DEBOUNCE_US);
+}
+
+static void armInterrupt() {
+  attachInterrupt(digitalPinToInterrupt(buttonPin), buttonIsr, FALLING);
+}
+
+void buttonBegin(int pin) {
+  buttonPin = pin;
+  pinMode(buttonPin, INPUT_PULLUP);
+  esp_timer_create_args_t args = {};
+  args.callback = debounceExpired;
+  args.name = "button";
+  esp_timer_create(&args, &debounceTimer);
+  armInterrupt();
+}
+
+// Рівневе пробудження перепрограмовує тип переривання піна, тому після сну повертаємо фронт
+void buttonPrepareLightSleep() {
+  gpio_wakeup_enable(static_cast<gpio_num_t>(buttonPin), GPIO_INTR_LOW_LEVEL);
+  esp_sleep_enable_gpio_wakeup();
+}
+
+void buttonAfterLightSleep(bool wokeByButton) {
+  gpio_wakeup_disable(static_cast<gpio_num_t>(buttonPin));
+  armInterrupt();
+  // Фронт міг прийти, поки ядро спало: запускаємо перевірку брязкоту вручну
+  if (wokeByButton && !debouncePending) {
+    debouncePending = true;
+    esp_timer_start_once(debounceTimer, BUTTON_DEBOUNCE_US);
+  }
+}
+
+void buttonPrepareDeepSleep() {
+  detachInterrupt(digitalPinToInterrupt(buttonPin));
+  esp_deep_sleep_enable_gpio_wakeup(1ULL << buttonPin, ESP_GPIO_WAKEUP_GPIO_LOW);
+}
+
+bool buttonWokeFromDeepSleep() {
+  return esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+}
+
+uint32_t buttonPressCount() {
+  return pressCount;
+}
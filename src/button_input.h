@@ -0,0 +1,20 @@
+#ifndef BUTTON_INPUT_H
+#define BUTTON_INPUT_H
+
+#include <Arduino.h>
+
+// === Button ===
+// Спадний фронт -> переривання -> одноразовий esp_timer на час брязкоту ->
+// якщо кнопка досі натиснута, у чергу руху ставиться годування.
+// Та сама кнопка будить з light і deep sleep.
+extern const unsigned long BUTTON_DEBOUNCE_US;
+
+// === Button Functions ===
+void buttonBegin(int pin);
+void buttonPrepareLightSleep();
+void buttonAfterLightSleep(bool wokeByButton);
+void buttonPrepareDeepSleep();
+bool buttonWokeFromDeepSleep();
+uint32_t buttonPressCount();
+
+#endif
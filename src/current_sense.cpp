@@ -0,0 +1,119 @@
+#include "current_sense.h"
+#include "event_log.h"
+#include "app_config.h"
+#include "local_time.h"
+
+// === Current sense ===
+// Аналоговий вихід шунтового підсилювача на шині серво (0.05 Ом x 20 = 1 В/А)
+const uint32_t CURRENT_SENSE_MV_PER_A = 1000;
+const unsigned long STALL_SAMPLE_INTERVAL_US = 1000; // 1 кГц під час руху
+static const float SETTLE_MARGIN_MA = 80.0f;         // вище струму утримання - вал ще рухається
+static const unsigned long SETTLE_HOLD_US = 20000;
+
+StallDetector stallDetector;
+
+static int currentSensePin = -1;
+static unsigned long lastMoveStartUs = 0;
+
+// === Fault log ===
+static FaultEvent faultLog[FAULT_LOG_SIZE];
+static int faultHead = 0;
+static int faultTotal = 0;
+
+void currentSenseBegin(int pin) {
+  currentSensePin = pin;
+  if (currentSensePin < 0) return;
+  pinMode(currentSensePin, INPUT);
+  analogSetPinAttenuation(currentSensePin, ADC_11db);
+  stallDetector.config.thresholdMa = appConfig.stallMa;
+  stallDetector.config.holdUs = appConfig.stallHoldMs * 1000UL;
+}
+
+bool currentSenseAvailable() {
+  return currentSensePin >= 0;
+}
+
+// Швидкий шлях: одна вибірка АЦП без усереднення - фільтрує детектор
+uint32_t currentSenseReadMa() {
+  if (currentSensePin < 0) return 0;
+  uint32_t raw = analogRead(currentSensePin);
+  uint32_t mv = raw * 3300U / 4095U;
+  return mv * 1000U / CURRENT_SENSE_MV_PER_A;
+}
+
+// Хук servo_motion: викликається під час руху, true - зупинити рух
+bool currentSenseMotionSample(unsigned long moveStartUs, unsigned long nowUs) {
+  if (currentSensePin < 0) return false;
+  if (moveStartUs != lastMoveStartUs) {
+    lastMoveStartUs = moveStartUs;
+    stallDetector.reset(moveStartUs);
+  }
+  return stallDetector.update(nowUs, currentSenseReadMa());
+}
+
+// Після кінця профілю: чекаємо, поки відфільтрований струм шини не втримається
+// біля idleMa SETTLE_HOLD_US. settledUs - початок цього затишшя (micros())
+bool currentSenseWaitSettled(float idleMa, unsigned long timeoutUs, unsigned long& settledUs) {
+  if (currentSensePin < 0) return false;
+  const unsigned long startUs = micros();
+  float filteredMa = currentSenseReadMa();
+  bool quiet = false;
+  unsigned long quietSinceUs = 0;
+  while (micros() - startUs < timeoutUs) {
+    const unsigned long nowUs = micros();
+    filteredMa += stallDetector.config.filterAlpha * (currentSenseReadMa() - filteredMa);
+    if (filteredMa > idleMa + SETTLE_MARGIN_MA) {
+      quiet = false;
+    } else if (!quiet) {
+      quiet = true;
+      quietSinceUs = nowUs;
+    } else if (nowUs - quietSinceUs >= SETTLE_HOLD_US) {
+      settledUs = quietSinceUs;
+      return true;
+    }
+    delayMicroseconds(STALL_SAMPLE_INTERVAL_US);
+  }
+  return false;
+}
+
+void setStallThreshold(float thresholdMa, unsigned long holdMs, Preferences& preferences) {
+  stallDetector.config.thresholdMa = constrain(thresholdMa, 200.0f, 5000.0f);
+  stallDetector.config.holdUs = constrain(holdMs, 10UL, 1000UL) * 1000UL;
+  appConfig.stallMa = stallDetector.config.thresholdMa;
+  appConfig.stallHoldMs = stallDetector.config.holdUs / 1000;
+  appConfigSave(preferences);
+}
+
+void recordFault(FaultKind kind, float angle) {
+  FaultEvent& ev = faultLog[faultHead];
+  ev.uptimeS = millis() / 1000;
+  ev.epoch = localClockValid() ? static_cast<uint32_t>(localClockUtc()) : 0; // 0 - час не синхронізовано
+  ev.peakMa = static_cast<uint16_t>(min(stallDetector.peakMa, 65535.0f));
+  ev.kind = kind;
+  ev.angle = static_cast<uint8_t>(constrain(angle, 0.0f, 180.0f) + 0.5f);
+  faultHead = (faultHead + 1) % FAULT_LOG_SIZE;
+  faultTotal++;
+  eventLogAppend(EVENT_FAULT, kind, ev.angle, ev.peakMa);
+  Serial.printf("Fault %d at %d deg, peak %u mA\n", kind, ev.angle, ev.peakMa);
+}
+
+int faultCount() {
+  return faultTotal;
+}
+
+String faultsToJson() {
+  String json = "[";
+  int stored = min(faultTotal, FAULT_LOG_SIZE);
+  for (int i = 0; i < stored; ++i) {
+    int idx = (faultHead - 1 - i + FAULT_LOG_SIZE) % FAULT_LOG_SIZE;
+    const FaultEvent& ev = faultLog[idx];
+    if (i > 0) json += ",";
+    json += "{\"kind\":\"" + String(ev.kind == FAULT_STALL ? "stall" : "unknown") + "\"";
+    json += ",\"uptime\":" + String(ev.uptimeS);
+    json += ",\"epoch\":" + String(ev.epoch);
+    json += ",\"angle\":" + String(ev.angle);
+    json += ",\"peakMa\":" + String(ev.peakMa) + "}";
+  }
+  json += "]";
+  return json;
+}
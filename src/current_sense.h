@@ -0,0 +1,39 @@
+#ifndef CURRENT_SENSE_H
+#define CURRENT_SENSE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include "stall_detector.h"
+
+// === Current sense ===
+extern const uint32_t CURRENT_SENSE_MV_PER_A;
+extern const unsigned long STALL_SAMPLE_INTERVAL_US;
+extern StallDetector stallDetector;
+
+// === Fault log ===
+#define FAULT_LOG_SIZE 8
+
+enum FaultKind : uint8_t {
+  FAULT_STALL = 1,
+};
+
+struct FaultEvent {
+  uint32_t uptimeS;
+  uint32_t epoch;
+  uint16_t peakMa;
+  uint8_t kind;
+  uint8_t angle;
+};
+
+// === Current Sense Functions ===
+void currentSenseBegin(int pin);
+bool currentSenseAvailable();
+uint32_t currentSenseReadMa();
+bool currentSenseMotionSample(unsigned long moveStartUs, unsigned long nowUs);
+bool currentSenseWaitSettled(float idleMa, unsigned long timeoutUs, unsigned long& settledUs);
+void setStallThreshold(float thresholdMa, unsigned long holdMs, Preferences& preferences);
+void recordFault(FaultKind kind, float angle);
+int faultCount();
+String faultsToJson();
+
+#endif
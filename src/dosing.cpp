@@ -0,0 +1,118 @@
+#include "dosing.h"
+
+static const uint8_t DOSE_CAL_VERSION = 1;
+static const int DOSE_MAX_SWEEPS = 50;
+
+DoseCalibration doseCalibration = {};
+
+void dosingLoad(Preferences& preferences) {
+  DoseCalibration stored = {};
+  size_t len = preferences.getBytes("doseCal", &stored, sizeof(stored));
+  if (len == sizeof(stored) && stored.version == DOSE_CAL_VERSION && stored.count <= DOSE_CAL_POINTS) {
+    doseCalibration = stored;
+  } else {
+    doseCalibration = {};
+    doseCalibration.version = DOSE_CAL_VERSION;
+  }
+}
+
+bool dosingCalibrated() {
+  return doseCalibration.count > 0;
+}
+
+// Точка з тим самим кутом (±1°) перезаписується, інакше вставляється за зростанням кута
+bool dosingAddPoint(float travelDeg, int sweeps, float grams, Preferences& preferences) {
+  if (travelDeg < 1.0f || travelDeg > 180.0f || sweeps < 1 || grams <= 0.0f) return false;
+  const float gps = grams / sweeps;
+
+  DoseCalibrationPoint* p = doseCalibration.points;
+  int count = doseCalibration.count;
+  int idx = 0;
+  while (idx < count && p[idx].travelDeg < travelDeg - 1.0f) idx++;
+  if (idx < count && fabsf(p[idx].travelDeg - travelDeg) <= 1.0f) {
+    p[idx] = {travelDeg, gps};
+  } else {
+    if (count >= DOSE_CAL_POINTS) return false;
+    for (int i = count; i > idx; --i) p[i] = p[i - 1];
+    p[idx] = {travelDeg, gps};
+    doseCalibration.count++;
+  }
+  preferences.putBytes("doseCal", &doseCalibration, sizeof(doseCalibration));
+  return true;
+}
+
+void dosingClear(Preferences& preferences) {
+  doseCalibration = {};
+  doseCalibration.version = DOSE_CAL_VERSION;
+  preferences.remove("doseCal");
+}
+
+// Кусково-лінійна крива від (0°, 0 г); вище останньої точки не екстраполюємо
+float gramsPerSweepAt(float travelDeg) {
+  if (!dosingCalibrated() || travelDeg <= 0.0f) return 0.0f;
+  float prevTravel = 0.0f;
+  float prevGrams = 0.0f;
+  for (int i = 0; i < doseCalibration.count; ++i) {
+    const DoseCalibrationPoint& p = doseCalibration.points[i];
+    if (travelDeg <= p.travelDeg) {
+      float t = (travelDeg - prevTravel) / (p.travelDeg - prevTravel);
+      return prevGrams + t * (p.gramsPerSweep - prevGrams);
+    }
+    prevTravel = p.travelDeg;
+    prevGrams = p.gramsPerSweep;
+  }
+  return prevGrams;
+}
+
+// Мінімальна кількість ходів, а потім мінімальний кут, що дає потрібну дозу
+DosePlan planDose(float grams, float maxTravelDeg) {
+  DosePlan plan;
+  if (!dosingCalibrated() || grams <= 0.0f) return plan;
+
+  const DoseCalibrationPoint& last = doseCalibration.points[doseCalibration.count - 1];
+  const float topTravel = min(maxTravelDeg, last.travelDeg);
+  const float topGrams = gramsPerSweepAt(topTravel);
+  if (topGrams <= 0.0f) return plan;
+
+  int sweeps = static_cast<int>(ceilf(grams / topGrams - 0.001f));
+  plan.capped = sweeps > DOSE_MAX_SWEEPS;
+  sweeps = constrain(sweeps, 1, DOSE_MAX_SWEEPS);
+  const float perSweep = grams / sweeps;
+
+  float travel = topTravel;
+  float prevTravel = 0.0f;
+  float prevGrams = 0.0f;
+  for (int i = 0; i < doseCalibration.count; ++i) {
+    const DoseCalibrationPoint& p = doseCalibration.points[i];
+    if (perSweep <= p.gramsPerSweep && p.gramsPerSweep > prevGrams) {
+      float t = (perSweep - prevGrams) / (p.gramsPerSweep - prevGrams);
+      travel = prevTravel + t * (p.travelDeg - prevTravel);
+      break;
+    }
+    prevTravel = p.travelDeg;
+    prevGrams = p.gramsPerSweep;
+  }
+
+  plan.sweeps = sweeps;
+  plan.travelDeg = min(travel, topTravel);
+  plan.expectedGrams = sweeps * gramsPerSweepAt(plan.travelDeg);
+  return plan;
+}
+
+// Найбільша доза за одне годування: DOSE_MAX_SWEEPS повних ходів, 0 - без калібрування
+float dosingMaxGrams(float maxTravelDeg) {
+  if (!dosingCalibrated()) return 0.0f;
+  const float topTravel = min(maxTravelDeg, doseCalibration.points[doseCalibration.count - 1].travelDeg);
+  return DOSE_MAX_SWEEPS * gramsPerSweepAt(topTravel);
+}
+
+String dosingToJson() {
+  String json = "[";
+  for (int i = 0; i < doseCalibration.count; ++i) {
+    if (i > 0) json += ",";
+    json += "{\"travel\":" + String(doseCalibration.points[i].travelDeg, 1) +
+            ",\"gramsPerSweep\":" + String(doseCalibration.points[i].gramsPerSweep, 3) + "}";
+  }
+  json += "]";
+  return json;
+}
@@ -0,0 +1,42 @@
+#ifndef DOSING_H
+#define DOSING_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// === Dosing model ===
+// Крива бункера: скільки грамів корму висипає один хід на заданий кут.
+// Точки знімаються через API (прогін N ходів + зважування).
+#define DOSE_CAL_POINTS 6
+
+struct DoseCalibrationPoint {
+  float travelDeg;
+  float gramsPerSweep;
+};
+
+struct DoseCalibration {
+  uint8_t version;
+  uint8_t count;
+  DoseCalibrationPoint points[DOSE_CAL_POINTS];
+};
+
+struct DosePlan {
+  int sweeps = 0;
+  float travelDeg = 0.0f;
+  float expectedGrams = 0.0f;
+  bool capped = false;      // потрібно більше ходів, ніж дозволено: expectedGrams менше за запит
+};
+
+extern DoseCalibration doseCalibration;
+
+// === Dosing Functions ===
+void dosingLoad(Preferences& preferences);
+bool dosingCalibrated();
+bool dosingAddPoint(float travelDeg, int sweeps, float grams, Preferences& preferences);
+void dosingClear(Preferences& preferences);
+float gramsPerSweepAt(float travelDeg);
+DosePlan planDose(float grams, float maxTravelDeg);
+float dosingMaxGrams(float maxTravelDeg);
+String dosingToJson();
+
+#endif
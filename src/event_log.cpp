@@ -0,0 +1,277 @@
+#include "event_log.h"
+#include "local_time.h"
+#include "current_sense.h"
+#include <esp_partition.h>
+#include <esp_sleep.h>
+
+static const size_t EVENT_SECTOR_SIZE = 4096;
+static const uint32_t SLOTS_PER_SECTOR = EVENT_SECTOR_SIZE / sizeof(EventRecord);
+static const uint32_t ERASED_SEQ = 0xFFFFFFFF;
+
+// === Event log ===
+static const esp_partition_t* logPartition = nullptr;
+static uint32_t slotCount = 0;
+static uint32_t headSlot = 0;           // куди піде наступний запис
+static bool headSectorErased = false;
+static uint32_t nextSeq = 1;
+static uint32_t droppedCount = 0;
+
+static EventRecord eventQueue[EVENT_QUEUE_SIZE];
+static uint8_t queueHead = 0;
+static uint8_t queueCount = 0;
+
+static uint16_t crc16(const uint8_t* data, size_t len) {
+  uint16_t crc = 0xFFFF;
+  for (size_t i = 0; i < len; ++i) {
+    crc ^= static_cast<uint16_t>(data[i]) << 8;
+    for (int bit = 0; bit < 8; ++bit) {
+      crc = (crc & 0x8000) ? (crc << 1) ^ 0x1021 : crc << 1;
+    }
+  }
+  return crc;
+}
+
+static uint16_t recordCrc(const EventRecord& rec) {
+  return crc16(reinterpret_cast<const uint8_t*>(&rec), offsetof(EventRecord, crc));
+}
+
+static bool readSlot(uint32_t slot, EventRecord& rec) {
+  return esp_partition_read(logPartition, slot * sizeof(EventRecord), &rec, sizeof(rec)) == ESP_OK;
+}
+
+static bool recordValid(const EventRecord& rec) {
+  return rec.seq != ERASED_SEQ && rec.crc == recordCrc(rec);
+}
+
+// Перервний запис (втрата живлення) лишає не всі байти 0xFF - така комірка зайнята
+static bool recordErased(const EventRecord& rec) {
+  const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&rec);
+  for (size_t i = 0; i < sizeof(rec); ++i) {
+    if (bytes[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+// Найновіший сектор - з найбільшим seq першого запису; у ньому голова - перша стерта комірка.
+// seq наступного запису відповідає позиції, тож сторінки читаються без пошуку.
+static void findHead() {
+  uint32_t sectors = slotCount / SLOTS_PER_SECTOR;
+  int32_t newestSector = -1;
+  uint32_t newestSeq = 0;
+  EventRecord rec;
+  for (uint32_t s = 0; s < sectors; ++s) {
+    if (!readSlot(s * SLOTS_PER_SECTOR, rec) || !recordValid(rec)) continue;
+    if (newestSector < 0 || rec.seq > newestSeq) {
+      newestSector = s;
+      newestSeq = rec.seq;
+    }
+  }
+  if (newestSector < 0) {
+    headSlot = 0;
+    headSectorErased = false;
+    nextSeq = 1;
+    return;
+  }
+
+  uint32_t base = newestSector * SLOTS_PER_SECTOR;
+  uint32_t lastSeq = newestSeq;
+  uint32_t lastPos = 0;
+  uint32_t pos = 1;
+  for (; pos < SLOTS_PER_SECTOR; ++pos) {
+    if (!readSlot(base + pos, rec) || recordErased(rec)) break;
+    if (recordValid(rec)) {
+      lastSeq = rec.seq;
+      lastPos = pos;
+    }
+  }
+  nextSeq = lastSeq + (pos - lastPos);
+  headSlot = (base + pos) % slotCount;
+  headSectorErased = pos < SLOTS_PER_SECTOR;
+}
+
+bool eventLogBegin() {
+  logPartition = esp_partition_find_first(ESP_PARTITION_TYPE_DATA,
+                                          static_cast<esp_partition_subtype_t>(EVENT_PARTITION_SUBTYPE), "eventlog");
+  if (!logPartition || logPartition->size < 2 * EVENT_SECTOR_SIZE) {
+    logPartition = nullptr;
+    Serial.println("Event log partition not found");
+    return false;
+  }
+  slotCount = (logPartition->size / EVENT_SECTOR_SIZE) * SLOTS_PER_SECTOR;
+  findHead();
+  Serial.printf("Event log: %lu slots, next seq %lu\n",
+                static_cast<unsigned long>(slotCount), static_cast<unsigned long>(nextSeq));
+  return true;
+}
+
+bool eventLogAvailable() {
+  return logPartition != nullptr;
+}
+
+// Лише копія в RAM: викликається і з гарячих шляхів годування
+void eventLogAppend(EventType type, uint8_t source, uint8_t arg, uint16_t value) {
+  if (!logPartition) return;
+  if (queueCount >= EVENT_QUEUE_SIZE) {
+    droppedCount++;
+    return;
+  }
+  EventRecord& rec = eventQueue[(queueHead + queueCount) % EVENT_QUEUE_SIZE];
+  rec.seq = nextSeq++;
+  if (localClockValid()) {
+    rec.t = static_cast<uint32_t>(localClockUtc());
+    rec.flags = 0;
+  } else {
+    rec.t = millis() / 1000;
+    rec.flags = EVENT_FLAG_UPTIME;
+  }
+  rec.type = type;
+  rec.source = source;
+  rec.arg = arg;
+  rec.value = value;
+  queueCount++;
+}
+
+// Стирання сектора - десятки мс із вимкненим кешем флешу, тож лише тут, а не в eventLogAppend()
+// Комірку витрачено навіть при помилці: позиція має відповідати seq
+static void advanceHead() {
+  headSlot = (headSlot + 1) % slotCount;
+  if (headSlot % SLOTS_PER_SECTOR == 0) headSectorErased = false;
+}
+
+static bool writeRecord(EventRecord& rec) {
+  if (!headSectorErased) {
+    if (esp_partition_erase_range(logPartition, (headSlot / SLOTS_PER_SECTOR) * EVENT_SECTOR_SIZE,
+                                  EVENT_SECTOR_SIZE) != ESP_OK) {
+      // Сектор лишається нестертим: наступний запис спробує стерти його знову
+      advanceHead();
+      headSectorErased = false;
+      return false;
+    }
+    headSectorErased = true;
+  }
+  rec.crc = recordCrc(rec);
+  esp_err_t err = esp_partition_write(logPartition, headSlot * sizeof(EventRecord), &rec, sizeof(rec));
+  advanceHead();
+  return err == ESP_OK;
+}
+
+void eventLogFlush() {
+  while (queueCount > 0) {
+    if (!writeRecord(eventQueue[queueHead])) droppedCount++;
+    queueHead = (queueHead + 1) % EVENT_QUEUE_SIZE;
+    queueCount--;
+  }
+}
+
+// loop() не виконується під час руху серво: годування синхронне
+void eventLogTick() {
+  if (queueCount > 0) eventLogFlush();
+}
+
+int eventLogPending() {
+  return queueCount;
+}
+
+static const char* eventTypeName(uint8_t type) {
+  switch (type) {
+    case EVENT_BOOT: return "boot";
+    case EVENT_FEED_START: return "feedStart";
+    case EVENT_FEED_END: return "feedEnd";
+    case EVENT_FAULT: return "fault";
+    case EVENT_DOSE_CAPPED: return "doseCapped";
+    default: return "unknown";
+  }
+}
+
+const char* eventSourceName(uint8_t source) {
+  switch (source) {
+    case EVENT_SOURCE_SCHEDULE: return "schedule";
+    case EVENT_SOURCE_CATCHUP: return "catchup";
+    case EVENT_SOURCE_WEB: return "web";
+    case EVENT_SOURCE_BUTTON: return "button";
+    case EVENT_SOURCE_DOSE_TEST: return "doseTest";
+    default: return "none";
+  }
+}
+
+static const char* wakeCauseName(uint8_t cause) {
+  switch (cause) {
+    case ESP_SLEEP_WAKEUP_TIMER: return "timer";
+    case ESP_SLEEP_WAKEUP_GPIO: return "button";
+    case ESP_SLEEP_WAKEUP_UNDEFINED: return "reset";
+    default: return "other";
+  }
+}
+
+static String recordToJson(const EventRecord& rec) {
+  String json = "{\"seq\":" + String(rec.seq) + ",\"t\":" + String(rec.t);
+  if (rec.flags & EVENT_FLAG_UPTIME) json += ",\"uptime\":true";
+  json += ",\"ev\":\"" + String(eventTypeName(rec.type)) + "\"";
+  switch (rec.type) {
+    case EVENT_BOOT:
+      json += ",\"reset\":" + String(rec.source) + ",\"wake\":\"" + String(wakeCauseName(rec.arg)) + "\"";
+      json += ",\"mv\":" + String(rec.value);
+      break;
+    case EVENT_FEED_START:
+      json += ",\"src\":\"" + String(eventSourceName(rec.source)) + "\"";
+      json += ",\"sweeps\":" + String(rec.arg) + ",\"mv\":" + String(rec.value);
+      break;
+    case EVENT_FEED_END:
+      json += ",\"src\":\"" + String(eventSourceName(rec.source)) + "\"";
+      json += ",\"ok\":" + String(rec.arg ? "true" : "false") + ",\"ms\":" + String(rec.value * 10UL);
+      break;
+    case EVENT_FAULT:
+      json += ",\"kind\":\"" + String(rec.source == FAULT_STALL ? "stall" : "unknown") + "\"";
+      json += ",\"angle\":" + String(rec.arg) + ",\"peakMa\":" + String(rec.value);
+      break;
+    case EVENT_DOSE_CAPPED:
+      json += ",\"src\":\"" + String(eventSourceName(rec.source)) + "\"";
+      json += ",\"sweeps\":" + String(rec.arg) + ",\"shortGrams\":" + String(rec.value / 10.0f, 1);
+      break;
+    default:
+      break;
+  }
+  json += "}";
+  return json;
+}
+
+// Від новіших до старіших, починаючи з seq < beforeSeq (0 - від найновішого).
+// "next" - курсор для наступної сторінки, 0 - старіших записів немає.
+String eventLogToJson(uint32_t beforeSeq, int limit) {
+  if (!logPartition) return "{\"available\":false}";
+  eventLogFlush();
+  if (beforeSeq == 0 || beforeSeq > nextSeq) beforeSeq = nextSeq;
+  // Сектор голови вже стертий або буде стертий наступним записом
+  uint32_t capacity = slotCount - SLOTS_PER_SECTOR;
+
+  String events;
+  int emitted = 0;
+  uint32_t seq = beforeSeq;
+  bool more = false;
+  while (seq > 1 && nextSeq - (seq - 1) <= capacity) {
+    if (emitted >= limit) {
+      more = true;
+      break;
+    }
+    seq--;
+    uint32_t slot = (headSlot + slotCount - (nextSeq - seq)) % slotCount;
+    EventRecord rec;
+    if (!readSlot(slot, rec) || recordErased(rec)) break;
+    // Пошкоджений запис пропускаємо, але позиції далі все одно відповідають seq
+    if (!recordValid(rec)) continue;
+    if (rec.seq != seq) break;
+    if (emitted > 0) events += ",";
+    events += recordToJson(rec);
+    emitted++;
+  }
+
+  String json = "{";
+  json += "\"available\":true,";
+  json += "\"capacity\":" + String(capacity) + ",";
+  json += "\"lastSeq\":" + String(nextSeq - 1) + ",";
+  json += "\"dropped\":" + String(droppedCount) + ",";
+  json += "\"next\":" + String(more ? seq : 0) + ",";
+  json += "\"events\":[" + events + "]";
+  json += "}";
+  return json;
+}
@@ -0,0 +1,58 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+
+// === Event log ===
+// Журнал подій в окремому розділі флешу "eventlog" (partitions.csv): кільце
+// секторів по 4 КБ із записів по 16 байт з CRC. Найстаріший сектор стирається
+// цілим, тож знос розподіляється по всьому розділу. eventLogAppend() лише
+// кладе запис у чергу в RAM; на флеш черга скидається з loop(), поза рухом,
+// а поки радіо вимкнене - у найближчому вікні зв'язку (wifiDutyQueue()).
+#define EVENT_QUEUE_SIZE 32
+#define EVENT_PARTITION_SUBTYPE 0x40
+
+enum EventType : uint8_t {
+  EVENT_BOOT = 1,       // source - причина скидання, arg - причина пробудження, value - мВ
+  EVENT_FEED_START,     // arg - кількість ходів, value - мВ батареї
+  EVENT_FEED_END,       // arg - 1, якщо без заклинювання; value - тривалість у 10 мс
+  EVENT_FAULT,          // source - FaultKind, arg - кут, value - пік струму, мА
+  EVENT_DOSE_CAPPED,    // доза більша за ліміт ходів: arg - ходів, value - недодано, 0.1 г
+};
+
+enum EventSource : uint8_t {
+  EVENT_SOURCE_NONE = 0,
+  EVENT_SOURCE_SCHEDULE,
+  EVENT_SOURCE_CATCHUP,
+  EVENT_SOURCE_WEB,
+  EVENT_SOURCE_BUTTON,
+  EVENT_SOURCE_DOSE_TEST,
+};
+
+enum EventFlags : uint8_t {
+  EVENT_FLAG_UPTIME = 0x01,   // t - секунди від старту: годинник ще не встановлено
+};
+
+struct EventRecord {
+  uint32_t seq;               // 0xFFFFFFFF - стерта комірка
+  uint32_t t;
+  uint8_t type;
+  uint8_t flags;
+  uint8_t source;
+  uint8_t arg;
+  uint16_t value;
+  uint16_t crc;               // CRC-16/CCITT перших 14 байт
+};
+static_assert(sizeof(EventRecord) == 16, "EventRecord must stay 16 bytes");
+
+// === Event Log Functions ===
+bool eventLogBegin();
+bool eventLogAvailable();
+void eventLogAppend(EventType type, uint8_t source, uint8_t arg, uint16_t value);
+void eventLogTick();
+void eventLogFlush();
+int eventLogPending();
+String eventLogToJson(uint32_t beforeSeq, int limit);
+const char* eventSourceName(uint8_t source);
+
+#endif
@@ -0,0 +1,89 @@
+#include "feed_catchup.h"
+#include "app_config.h"
+
+const long CATCHUP_ON_TIME_S = 60;
+
+CatchupPolicy catchupPolicy = CATCHUP_ONCE;
+uint16_t catchupGraceMin = 120;
+
+static Preferences* catchupPreferences = nullptr;
+static uint32_t slotLastRun[CATCHUP_MAX_SLOTS] = {};
+static bool lastRunDirty = false;
+
+void catchupBegin(Preferences& preferences) {
+  catchupPreferences = &preferences;
+  uint8_t policy = appConfig.catchupPolicy;
+  catchupPolicy = policy <= CATCHUP_ALL ? static_cast<CatchupPolicy>(policy) : CATCHUP_ONCE;
+  catchupGraceMin = appConfig.catchupGraceMin;
+  if (preferences.getBytes("slotLastRun", slotLastRun, sizeof(slotLastRun)) != sizeof(slotLastRun)) {
+    memset(slotLastRun, 0, sizeof(slotLastRun));
+  }
+}
+
+void catchupSetPolicy(CatchupPolicy policy, uint16_t graceMin, Preferences& preferences) {
+  catchupPolicy = policy;
+  catchupGraceMin = constrain(graceMin, static_cast<uint16_t>(1), static_cast<uint16_t>(12 * 60));
+  appConfig.catchupPolicy = catchupPolicy;
+  appConfig.catchupGraceMin = catchupGraceMin;
+  appConfigSave(preferences);
+}
+
+const char* catchupPolicyName(CatchupPolicy policy) {
+  switch (policy) {
+    case CATCHUP_SKIP: return "skip";
+    case CATCHUP_ALL: return "all";
+    default: return "once";
+  }
+}
+
+bool catchupPolicyFromName(const String& name, CatchupPolicy& policy) {
+  if (name == "skip") policy = CATCHUP_SKIP;
+  else if (name == "once") policy = CATCHUP_ONCE;
+  else if (name == "all") policy = CATCHUP_ALL;
+  else return false;
+  return true;
+}
+
+// Останнє настання hh:mm за місцевим часом, не пізніше за now (UTC)
+time_t lastOccurrence(int hour, int minute, time_t now, long utcOffsetS) {
+  time_t local = now + utcOffsetS;
+  time_t midnight = local - (local % 86400);
+  time_t slot = midnight + hour * 3600L + minute * 60L;
+  if (slot > local) slot -= 86400;
+  return slot - utcOffsetS;
+}
+
+// Невідомий час виконання (0) - перший запуск або новий розклад: минуле не надолужуємо
+SlotDue catchupClassify(int slot, time_t occurrence, time_t now) {
+  if (slot < 0 || slot >= CATCHUP_MAX_SLOTS) return SLOT_NOT_DUE;
+  uint32_t lastRun = slotLastRun[slot];
+  if (lastRun != 0 && static_cast<time_t>(lastRun) >= occurrence) return SLOT_NOT_DUE;
+  long lateS = static_cast<long>(now - occurrence);
+  if (lateS < CATCHUP_ON_TIME_S) return SLOT_ON_TIME;
+  if (lastRun == 0 || lateS > catchupGraceMin * 60L) return SLOT_EXPIRED;
+  return SLOT_MISSED;
+}
+
+void catchupMarkRun(int slot, time_t occurrence) {
+  if (slot < 0 || slot >= CATCHUP_MAX_SLOTS) return;
+  slotLastRun[slot] = static_cast<uint32_t>(occurrence);
+  lastRunDirty = true;
+}
+
+uint32_t catchupLastRun(int slot) {
+  return slot >= 0 && slot < CATCHUP_MAX_SLOTS ? slotLastRun[slot] : 0;
+}
+
+// Після зміни розкладу індекси слотів уже не відповідають старим записам
+void catchupForgetSlots() {
+  memset(slotLastRun, 0, sizeof(slotLastRun));
+  lastRunDirty = true;
+  catchupSave();
+}
+
+// Один запис у NVS на прохід планувальника, а не на кожен слот
+void catchupSave() {
+  if (!lastRunDirty || !catchupPreferences) return;
+  catchupPreferences->putBytes("slotLastRun", slotLastRun, sizeof(slotLastRun));
+  lastRunDirty = false;
+}
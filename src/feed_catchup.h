@@ -0,0 +1,43 @@
+#ifndef FEED_CATCHUP_H
+#define FEED_CATCHUP_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <time.h>
+
+// === Missed-feed catch-up ===
+// Для кожного слота зберігаємо час останнього виконаного годування (UTC).
+// Слот "належить" до виконання, якщо його останнє настання пізніше за цей час:
+// так годування не губиться через сон, перезавантаження чи довге підключення.
+#define CATCHUP_MAX_SLOTS 32
+
+enum CatchupPolicy : uint8_t {
+  CATCHUP_SKIP = 0,     // пропущене не надолужуємо
+  CATCHUP_ONCE,         // одне годування за всі пропущені слоти
+  CATCHUP_ALL           // кожен пропущений слот окремо
+};
+
+enum SlotDue : uint8_t {
+  SLOT_NOT_DUE = 0,
+  SLOT_ON_TIME,         // настав щойно (у межах хвилини)
+  SLOT_MISSED,          // пропущено, але в межах вікна
+  SLOT_EXPIRED          // пропущено давно або час виконання невідомий
+};
+
+extern const long CATCHUP_ON_TIME_S;
+extern CatchupPolicy catchupPolicy;
+extern uint16_t catchupGraceMin;
+
+// === Catch-up Functions ===
+void catchupBegin(Preferences& preferences);
+void catchupSetPolicy(CatchupPolicy policy, uint16_t graceMin, Preferences& preferences);
+const char* catchupPolicyName(CatchupPolicy policy);
+bool catchupPolicyFromName(const String& name, CatchupPolicy& policy);
+time_t lastOccurrence(int hour, int minute, time_t now, long utcOffsetS);
+SlotDue catchupClassify(int slot, time_t occurrence, time_t now);
+void catchupMarkRun(int slot, time_t occurrence);
+uint32_t catchupLastRun(int slot);
+void catchupForgetSlots();
+void catchupSave();
+
+#endif
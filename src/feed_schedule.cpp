@@ -0,0 +1,217 @@
+#include "feed_schedule.h"
+#include "feed_catchup.h"
+
+static const uint8_t SCHEDULE_VERSION = 1;
+static const int SCHEDULE_LOOKAHEAD_DAYS = 7 * SCHEDULE_MAX_EVERY_DAYS;  // повний період тижня й інтервалу
+
+struct __attribute__((packed)) ScheduleBlob {
+  uint8_t version;
+  uint8_t count;
+  FeedTime slots[MAX_FEED_TIMES];
+};
+
+FeedTime feedTimes[MAX_FEED_TIMES];
+int feedTimesCount = 0;
+
+// === Daily index ===
+static uint8_t todayOrder[MAX_FEED_TIMES];
+static uint8_t todayCount = 0;
+static uint8_t todayCursor = 0;
+static int32_t indexedDay = -1;
+static bool indexDirty = true;
+static int32_t laterDayOffset = -1;   // через скільки діб перше годування після сьогодні
+static uint8_t laterSlot = 0;
+
+FeedTime makeFeedTime(int hour, int minute, int repeats, float grams) {
+  FeedTime slot = {};
+  slot.minuteOfDay = constrain(hour, 0, 23) * 60 + constrain(minute, 0, 59);
+  slot.repeats = constrain(repeats, 1, 31);
+  slot.weekdays = SCHEDULE_ALL_DAYS;
+  slot.everyDays = 1;
+  slot.gramsTenths = static_cast<uint16_t>(lroundf(constrain(grams, 0.0f, 500.0f) * 10.0f));
+  slot.startDay = SCHEDULE_OPEN_START;
+  slot.endDay = SCHEDULE_OPEN_END;
+  return slot;
+}
+
+// Середня кількість годувань слота на добу - для прогнозу батареї
+float feedDaysPerDay(const FeedTime& slot) {
+  int days = 0;
+  for (int d = 0; d < 7; ++d) {
+    if (slot.weekdays & (1 << d)) days++;
+  }
+  return days / 7.0f / max(static_cast<uint8_t>(1), slot.everyDays);
+}
+
+void scheduleRemoveLegacyKeys(Preferences& preferences) {
+  static const char* const LEGACY_KEYS[] = {
+    "feedHour1", "feedMinute1", "feedRepeats1", "feedHour2", "feedMinute2", "feedRepeats2"
+  };
+  for (const char* key : LEGACY_KEYS) preferences.remove(key);
+}
+
+// Старі формати: окремі ключі feedH0..feedG19 або два фіксовані годування
+static void loadLegacy(Preferences& preferences) {
+  int count = preferences.getInt("feedTimesCount", 0);
+  if (count <= 0 || count > 20) {
+    int storedH1 = preferences.getInt("feedHour1", -1);
+    int storedM1 = preferences.getInt("feedMinute1", -1);
+    int storedR1 = preferences.getInt("feedRepeats1", -1);
+
+    if (storedH1 < 0) storedH1 = 10;
+    if (storedM1 < 0) storedM1 = 0;
+    if (storedR1 < 0) storedR1 = 1;
+    scheduleAdd(makeFeedTime(storedH1, storedM1, storedR1, 0.0f));
+
+    if (preferences.isKey("feedHour2") && preferences.isKey("feedMinute2")) {
+      int storedH2 = preferences.getInt("feedHour2", storedH1);
+      int storedM2 = preferences.getInt("feedMinute2", storedM1);
+      int storedR2 = preferences.getInt("feedRepeats2", storedR1);
+      scheduleAdd(makeFeedTime(storedH2, storedM2, storedR2, 0.0f));
+    }
+    scheduleRemoveLegacyKeys(preferences);
+    return;
+  }
+  char key[20];
+  for (int i = 0; i < count; i++) {
+    sprintf(key, "feedH%d", i);
+    int h = preferences.getInt(key, 10);
+    preferences.remove(key);
+    sprintf(key, "feedM%d", i);
+    int m = preferences.getInt(key, 0);
+    preferences.remove(key);
+    sprintf(key, "feedR%d", i);
+    int r = preferences.getInt(key, 1);
+    preferences.remove(key);
+    sprintf(key, "feedG%d", i);
+    float g = preferences.getFloat(key, 0.0f);
+    preferences.remove(key);
+    scheduleAdd(makeFeedTime(h, m, r, g));
+  }
+  preferences.remove("feedTimesCount");
+  scheduleRemoveLegacyKeys(preferences);
+}
+
+void scheduleLoad(Preferences& preferences) {
+  ScheduleBlob blob = {};
+  size_t len = preferences.getBytes("schedule", &blob, sizeof(blob));
+  scheduleClear();
+  if (len >= 2 && blob.version == SCHEDULE_VERSION && blob.count <= MAX_FEED_TIMES &&
+      len == 2 + blob.count * sizeof(FeedTime)) {
+    for (int i = 0; i < blob.count; ++i) scheduleAdd(blob.slots[i]);
+    return;
+  }
+  loadLegacy(preferences);
+  scheduleSave(preferences);
+}
+
+// Зберігаємо лише зайняті слоти: 2 + 10 * N байт
+void scheduleSave(Preferences& preferences) {
+  ScheduleBlob blob = {};
+  blob.version = SCHEDULE_VERSION;
+  blob.count = feedTimesCount;
+  memcpy(blob.slots, feedTimes, feedTimesCount * sizeof(FeedTime));
+  preferences.putBytes("schedule", &blob, 2 + feedTimesCount * sizeof(FeedTime));
+}
+
+void scheduleClear() {
+  feedTimesCount = 0;
+  memset(feedTimes, 0, sizeof(feedTimes));
+  indexDirty = true;
+}
+
+bool scheduleAdd(const FeedTime& slot) {
+  if (feedTimesCount >= MAX_FEED_TIMES) return false;
+  FeedTime& added = feedTimes[feedTimesCount++];
+  added = slot;
+  if (added.minuteOfDay >= 24 * 60) added.minuteOfDay = 0;
+  if (added.repeats == 0) added.repeats = 1;
+  added.weekdays &= SCHEDULE_ALL_DAYS;
+  added.everyDays = constrain(added.everyDays, 1, SCHEDULE_MAX_EVERY_DAYS);
+  indexDirty = true;
+  return true;
+}
+
+bool scheduleActiveOn(const FeedTime& slot, int32_t day, uint8_t weekday) {
+  if (day < slot.startDay || day > slot.endDay) return false;
+  if (!(slot.weekdays & (1 << weekday))) return false;
+  return slot.everyDays <= 1 || (day - slot.startDay) % slot.everyDays == 0;
+}
+
+// Раз на добу (або після зміни розкладу): слоти на сьогодні за часом і перший
+// слот після сьогодні. Далі кожен запит - лише зсув курсора.
+static void buildIndex(int32_t day, uint8_t weekday) {
+  todayCount = 0;
+  for (int i = 0; i < feedTimesCount; ++i) {
+    if (!scheduleActiveOn(feedTimes[i], day, weekday)) continue;
+    int pos = todayCount++;
+    while (pos > 0 && feedTimes[todayOrder[pos - 1]].minuteOfDay > feedTimes[i].minuteOfDay) {
+      todayOrder[pos] = todayOrder[pos - 1];
+      pos--;
+    }
+    todayOrder[pos] = i;
+  }
+  todayCursor = 0;
+
+  laterDayOffset = -1;
+  for (int d = 1; d <= SCHEDULE_LOOKAHEAD_DAYS && laterDayOffset < 0; ++d) {
+    uint8_t wd = (weekday + d) % 7;
+    for (int i = 0; i < feedTimesCount; ++i) {
+      if (!scheduleActiveOn(feedTimes[i], day + d, wd)) continue;
+      if (laterDayOffset < 0 || feedTimes[i].minuteOfDay < feedTimes[laterSlot].minuteOfDay) {
+        laterDayOffset = d;
+        laterSlot = i;
+      }
+    }
+  }
+  indexedDay = day;
+  indexDirty = false;
+}
+
+// Слот у поточну хвилину вже не "наступний": як і раніше, він переходить на наступний раз
+bool scheduleNext(int32_t day, uint8_t weekday, uint16_t minuteOfDay, ScheduleNext& out) {
+  if (indexDirty || day != indexedDay) buildIndex(day, weekday);
+  // Годинник переставили назад - курсор треба почати спочатку
+  if (todayCursor > 0 && feedTimes[todayOrder[todayCursor - 1]].minuteOfDay > minuteOfDay) todayCursor = 0;
+  while (todayCursor < todayCount && feedTimes[todayOrder[todayCursor]].minuteOfDay <= minuteOfDay) todayCursor++;
+
+  if (todayCursor < todayCount) {
+    out.slot = todayOrder[todayCursor];
+    out.minutesUntil = feedTimes[out.slot].minuteOfDay - minuteOfDay;
+  } else if (laterDayOffset > 0) {
+    out.slot = laterSlot;
+    out.minutesUntil = laterDayOffset * 24 * 60 + feedTimes[out.slot].minuteOfDay - minuteOfDay;
+  } else {
+    return false;
+  }
+  out.minuteOfDay = feedTimes[out.slot].minuteOfDay;
+  return true;
+}
+
+// Останнє настання слота не пізніше за now, якщо воно було сьогодні або вчора;
+// старіші пропуски все одно за межами вікна catch-up (до 12 год). 0 - немає.
+time_t scheduleLastOccurrence(int slot, time_t now, long utcOffsetS) {
+  if (slot < 0 || slot >= feedTimesCount) return 0;
+  const FeedTime& s = feedTimes[slot];
+  time_t occurrence = lastOccurrence(feedHour(s), feedMinute(s), now, utcOffsetS);
+  int32_t day = (static_cast<uint32_t>(occurrence) + utcOffsetS) / 86400;
+  for (int back = 0; back < 2; ++back, --day) {
+    if (scheduleActiveOn(s, day, (day + 4) % 7)) return occurrence;   // 1970-01-01 - четвер
+    occurrence -= 86400;
+  }
+  return 0;
+}
+
+String scheduleToJson() {
+  String json = "[";
+  for (int i = 0; i < feedTimesCount; i++) {
+    const FeedTime& s = feedTimes[i];
+    if (i > 0) json += ",";
+    json += "{\"h\":" + String(feedHour(s)) + ",\"m\":" + String(feedMinute(s)) +
+            ",\"r\":" + String(s.repeats) + ",\"g\":" + String(feedGrams(s), 1) +
+            ",\"w\":" + String(s.weekdays) + ",\"n\":" + String(s.everyDays) +
+            ",\"s\":" + String(s.startDay) + ",\"e\":" + String(s.endDay) + "}";
+  }
+  json += "]";
+  return json;
+}
@@ -0,0 +1,55 @@
+#ifndef FEED_SCHEDULE_H
+#define FEED_SCHEDULE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <time.h>
+
+// === Feed schedule ===
+// Слот годування в 10 байтах: час доби, дні тижня, інтервал "раз на N діб"
+// і діапазон дат. Раз на добу будується індекс слотів, активних сьогодні,
+// відсортований за часом, тож наступне годування знаходиться за O(1).
+#define MAX_FEED_TIMES 32
+#define SCHEDULE_ALL_DAYS 0x7F        // біт 0 - неділя, як tm_wday
+#define SCHEDULE_OPEN_START 0
+#define SCHEDULE_OPEN_END 0xFFFF
+#define SCHEDULE_MAX_EVERY_DAYS 30
+
+struct __attribute__((packed)) FeedTime {
+  uint16_t minuteOfDay : 11;  // 0..1439
+  uint16_t repeats : 5;       // 1..31
+  uint8_t weekdays;
+  uint8_t everyDays;          // 1 - щодня, N - раз на N діб, рахуючи від startDay
+  uint16_t gramsTenths;       // доза в десятих грама (0 - використовувати repeats)
+  uint16_t startDay;          // місцевих діб від 1970-01-01, включно
+  uint16_t endDay;            // включно
+};
+static_assert(sizeof(FeedTime) == 10, "FeedTime must stay packed");
+
+struct ScheduleNext {
+  int slot = -1;
+  int32_t minutesUntil = -1;
+  uint16_t minuteOfDay = 0;
+};
+
+extern FeedTime feedTimes[MAX_FEED_TIMES];
+extern int feedTimesCount;
+
+// === Schedule Functions ===
+FeedTime makeFeedTime(int hour, int minute, int repeats, float grams);
+inline int feedHour(const FeedTime& slot) { return slot.minuteOfDay / 60; }
+inline int feedMinute(const FeedTime& slot) { return slot.minuteOfDay % 60; }
+inline float feedGrams(const FeedTime& slot) { return slot.gramsTenths / 10.0f; }
+float feedDaysPerDay(const FeedTime& slot);
+
+void scheduleLoad(Preferences& preferences);
+void scheduleRemoveLegacyKeys(Preferences& preferences);
+void scheduleSave(Preferences& preferences);
+void scheduleClear();
+bool scheduleAdd(const FeedTime& slot);
+bool scheduleActiveOn(const FeedTime& slot, int32_t day, uint8_t weekday);
+bool scheduleNext(int32_t day, uint8_t weekday, uint16_t minuteOfDay, ScheduleNext& out);
+time_t scheduleLastOccurrence(int slot, time_t now, long utcOffsetS);
+String scheduleToJson();
+
+#endif
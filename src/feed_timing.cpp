@@ -0,0 +1,102 @@
+#include "feed_timing.h"
+#include "latency_stats.h"
+#include "local_time.h"
+#include "servo_motion.h"
+#include "event_log.h"
+#include <esp_timer.h>
+
+// Затримка catch-up - години сну, у перцентилі вчасних годувань їй не місце
+static LatencyStats startLatencyMs;
+static LatencyStats catchupLateS;
+static LatencyStats durationMs;
+static LatencyStats stepCounts;
+
+static FeedTimingRecord recent[FEED_TIMING_RECENT];
+static uint8_t recentHead = 0;
+static uint8_t recentCount = 0;
+
+static uint32_t expectedUtc = 0;
+static FeedTimingRecord current = {};
+static int64_t startedUs = 0;
+static uint32_t startSteps = 0;
+
+// Запланований час слота для наступного feedTimingStart(), як batteryHistoryMark()
+void feedTimingExpect(uint32_t scheduledUtc) {
+  expectedUtc = scheduledUtc;
+}
+
+void feedTimingStart(uint8_t source) {
+  startedUs = esp_timer_get_time();
+  startSteps = motionStepCount();
+  current = {};
+  current.source = source;
+  current.scheduledUtc = expectedUtc;
+  expectedUtc = 0;
+  int64_t nowUs = localClockUtcMicros();
+  current.startUtc = static_cast<uint32_t>(nowUs / 1000000LL);
+  if (current.scheduledUtc && nowUs > 0) {
+    int64_t lateUs = nowUs - static_cast<int64_t>(current.scheduledUtc) * 1000000LL;
+    current.latencyMs = lateUs > 0 ? static_cast<uint32_t>(min(lateUs / 1000, static_cast<int64_t>(UINT32_MAX))) : 0;
+  }
+}
+
+void feedTimingFinish() {
+  current.durationMs = static_cast<uint32_t>((esp_timer_get_time() - startedUs) / 1000);
+  current.steps = motionStepCount() - startSteps;
+
+  if (current.scheduledUtc) {
+    if (current.source == EVENT_SOURCE_CATCHUP) {
+      catchupLateS.add(current.latencyMs / 1000);
+    } else {
+      startLatencyMs.add(current.latencyMs);
+    }
+  }
+  durationMs.add(current.durationMs);
+  stepCounts.add(current.steps);
+
+  recent[recentHead] = current;
+  recentHead = (recentHead + 1) % FEED_TIMING_RECENT;
+  if (recentCount < FEED_TIMING_RECENT) recentCount++;
+  Serial.printf("Feed timing: late %lu ms, took %lu ms, %lu steps\n",
+                static_cast<unsigned long>(current.latencyMs), static_cast<unsigned long>(current.durationMs),
+                static_cast<unsigned long>(current.steps));
+}
+
+void feedTimingReset() {
+  startLatencyMs.reset();
+  catchupLateS.reset();
+  durationMs.reset();
+  stepCounts.reset();
+  recentHead = 0;
+  recentCount = 0;
+}
+
+static String statsToJson(const LatencyStats& stats) {
+  String json = "{\"samples\":" + String(stats.total) + ",";
+  json += "\"p50\":" + String(stats.percentile(50)) + ",";
+  json += "\"p90\":" + String(stats.percentile(90)) + ",";
+  json += "\"p99\":" + String(stats.percentile(99)) + ",";
+  json += "\"max\":" + String(stats.maxValue()) + "}";
+  return json;
+}
+
+String feedTimingToJson() {
+  String json = "{";
+  json += "\"startLatencyMs\":" + statsToJson(startLatencyMs) + ",";
+  json += "\"catchupLateS\":" + statsToJson(catchupLateS) + ",";
+  json += "\"durationMs\":" + statsToJson(durationMs) + ",";
+  json += "\"steps\":" + statsToJson(stepCounts) + ",";
+  json += "\"recent\":[";
+  for (int i = 0; i < recentCount; ++i) {
+    const FeedTimingRecord& r = recent[(recentHead - 1 - i + FEED_TIMING_RECENT) % FEED_TIMING_RECENT];
+    if (i > 0) json += ",";
+    json += "{\"src\":\"" + String(eventSourceName(r.source)) + "\"";
+    json += ",\"scheduled\":" + String(r.scheduledUtc);
+    json += ",\"start\":" + String(r.startUtc);
+    json += ",\"latencyMs\":" + String(r.latencyMs);
+    json += ",\"durationMs\":" + String(r.durationMs);
+    json += ",\"steps\":" + String(r.steps) + "}";
+  }
+  json += "]}";
+  return json;
+}
@@ -0,0 +1,29 @@
+#ifndef FEED_TIMING_H
+#define FEED_TIMING_H
+
+#include <Arduino.h>
+
+// === Feed timing ===
+// Для кожного годування: запланований час слота, фактичний старт руху,
+// тривалість feedSequence() і кількість кадрів серво. Затримка старту
+// показує, скільки з'їдають пробудження з light sleep і підключення Wi-Fi,
+// тривалість і кадри - регресії рушія руху.
+#define FEED_TIMING_RECENT 8
+
+struct FeedTimingRecord {
+  uint32_t scheduledUtc;    // 0 - годування не з розкладу
+  uint32_t startUtc;
+  uint32_t latencyMs;
+  uint32_t durationMs;
+  uint32_t steps;
+  uint8_t source;           // EventSource
+};
+
+// === Feed Timing Functions ===
+void feedTimingExpect(uint32_t scheduledUtc);
+void feedTimingStart(uint8_t source);
+void feedTimingFinish();
+void feedTimingReset();
+String feedTimingToJson();
+
+#endif
@@ -0,0 +1,100 @@
+#include "idle_governor.h"
+#include "app_config.h"
+
+const unsigned long ACTIVITY_TIMEOUT = 300000;       // 5 хвилин бездіяльності до light sleep
+const unsigned long SLEEP_INTERVAL = 60000;          // light sleep шматками по хвилині
+const unsigned long AFTER_FEED_SLEEP_DELAY = 60000;  // прокинулись лише заради годування
+const long FEED_WAKE_MARGIN_S = 30;                  // прокидаємось трохи раніше за годування
+
+static const uint32_t DEEP_WAKE_LEAD_S = 120;        // завантаження + Wi-Fi + SNTP після deep sleep
+
+IdleGovernorConfig idleConfig = {30, ACTIVITY_TIMEOUT / 1000, 1800, 1200};
+
+static unsigned long lastActivity = 0;
+static bool wokeForFeed = false;
+static int pendingJobs = 0;
+static IdleLevel lastLevel = IDLE_ACTIVE;
+
+void idleGovernorBegin() {
+  if (appConfig.idle.modemAfterS <= appConfig.idle.lightAfterS) idleConfig = appConfig.idle;
+  lastActivity = millis();
+}
+
+void idleSetConfig(const IdleGovernorConfig& config, Preferences& preferences) {
+  idleConfig = config;
+  if (idleConfig.lightAfterS < idleConfig.modemAfterS) idleConfig.lightAfterS = idleConfig.modemAfterS;
+  if (idleConfig.deepAfterS != 0 && idleConfig.deepAfterS < idleConfig.lightAfterS) {
+    idleConfig.deepAfterS = idleConfig.lightAfterS;
+  }
+  appConfig.idle = idleConfig;
+  appConfigSave(preferences);
+}
+
+void idleNoteActivity() {
+  lastActivity = millis();
+  wokeForFeed = false;
+}
+
+// Після автогодування без відвідувачів засинаємо швидше, ніж після ручної дії
+void idleNoteFeedDone() {
+  lastActivity = millis();
+  wokeForFeed = true;
+}
+
+void idleJobBegin() {
+  pendingJobs++;
+}
+
+void idleJobEnd() {
+  if (pendingJobs > 0) pendingJobs--;
+}
+
+int idlePendingJobs() {
+  return pendingJobs;
+}
+
+unsigned long idleForMs() {
+  return millis() - lastActivity;
+}
+
+// secondsUntilFeed < 0 - час невідомий: без годинника не ризикуємо глибоким сном
+IdleLevel idleGovernorDecide(bool busy, long secondsUntilFeed) {
+  IdleLevel level = IDLE_ACTIVE;
+  if (!busy && pendingJobs == 0) {
+    unsigned long idleS = idleForMs() / 1000;
+    unsigned long lightAfterS = wokeForFeed ? min(static_cast<unsigned long>(idleConfig.lightAfterS), AFTER_FEED_SLEEP_DELAY / 1000)
+                                            : idleConfig.lightAfterS;
+    if (idleS >= idleConfig.modemAfterS) level = IDLE_MODEM_SLEEP;
+    if (idleS >= lightAfterS && secondsUntilFeed > FEED_WAKE_MARGIN_S * 2) level = IDLE_LIGHT_SLEEP;
+    if (idleConfig.deepAfterS > 0 && idleS >= idleConfig.deepAfterS &&
+        secondsUntilFeed >= static_cast<long>(max(idleConfig.deepMinLeadS, DEEP_WAKE_LEAD_S * 2))) {
+      level = IDLE_DEEP_SLEEP;
+    }
+  }
+  lastLevel = level;
+  return level;
+}
+
+// Light sleep шматками, щоб регулярно перевіряти розклад; deep sleep - до годування з запасом на старт
+uint64_t idleSleepMicros(IdleLevel level, long secondsUntilFeed) {
+  long sleepS = 0;
+  if (level == IDLE_LIGHT_SLEEP) {
+    sleepS = min(static_cast<long>(SLEEP_INTERVAL / 1000), secondsUntilFeed - FEED_WAKE_MARGIN_S);
+  } else if (level == IDLE_DEEP_SLEEP) {
+    sleepS = secondsUntilFeed - static_cast<long>(DEEP_WAKE_LEAD_S);
+  }
+  return sleepS > 0 ? static_cast<uint64_t>(sleepS) * 1000000ULL : 0;
+}
+
+const char* idleLevelName(IdleLevel level) {
+  switch (level) {
+    case IDLE_MODEM_SLEEP: return "modemSleep";
+    case IDLE_LIGHT_SLEEP: return "lightSleep";
+    case IDLE_DEEP_SLEEP: return "deepSleep";
+    default: return "active";
+  }
+}
+
+IdleLevel idleCurrentLevel() {
+  return lastLevel;
+}
@@ -0,0 +1,45 @@
+#ifndef IDLE_GOVERNOR_H
+#define IDLE_GOVERNOR_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// === Idle governor ===
+// Що довше нікого немає (HTTP, кнопка, задачі) і що далі наступне годування,
+// то глибший сон: modem sleep -> light sleep -> deep sleep.
+enum IdleLevel : uint8_t {
+  IDLE_ACTIVE = 0,
+  IDLE_MODEM_SLEEP,
+  IDLE_LIGHT_SLEEP,
+  IDLE_DEEP_SLEEP
+};
+
+// Зберігається в AppConfig::idle
+struct IdleGovernorConfig {
+  uint32_t modemAfterS;      // бездіяльність до modem sleep
+  uint32_t lightAfterS;      // бездіяльність до light sleep
+  uint32_t deepAfterS;       // бездіяльність до deep sleep, 0 - вимкнено
+  uint32_t deepMinLeadS;     // deep sleep лише якщо до годування не менше
+};
+
+extern IdleGovernorConfig idleConfig;
+extern const unsigned long ACTIVITY_TIMEOUT;
+extern const unsigned long SLEEP_INTERVAL;
+extern const unsigned long AFTER_FEED_SLEEP_DELAY;
+extern const long FEED_WAKE_MARGIN_S;
+
+// === Idle Governor Functions ===
+void idleGovernorBegin();
+void idleSetConfig(const IdleGovernorConfig& config, Preferences& preferences);
+void idleNoteActivity();
+void idleNoteFeedDone();
+void idleJobBegin();
+void idleJobEnd();
+int idlePendingJobs();
+unsigned long idleForMs();
+IdleLevel idleGovernorDecide(bool busy, long secondsUntilFeed);
+uint64_t idleSleepMicros(IdleLevel level, long secondsUntilFeed);
+const char* idleLevelName(IdleLevel level);
+IdleLevel idleCurrentLevel();
+
+#endif
@@ -0,0 +1,30 @@
+#include "latency_stats.h"
+#include <algorithm>
+
+void LatencyStats::reset() {
+  count = 0;
+  head = 0;
+  total = 0;
+}
+
+void LatencyStats::add(uint32_t value) {
+  samples[head] = value;
+  head = (head + 1) % LATENCY_WINDOW;
+  if (count < LATENCY_WINDOW) count++;
+  total++;
+}
+
+uint32_t LatencyStats::percentile(uint8_t pct) const {
+  if (count == 0) return 0;
+  uint32_t sorted[LATENCY_WINDOW];
+  std::copy(samples, samples + count, sorted);
+  uint32_t rank = (static_cast<uint32_t>(pct) * count + 99) / 100;
+  if (rank == 0) rank = 1;
+  std::nth_element(sorted, sorted + rank - 1, sorted + count);
+  return sorted[rank - 1];
+}
+
+uint32_t LatencyStats::maxValue() const {
+  if (count == 0) return 0;
+  return *std::max_element(samples, samples + count);
+}
@@ -0,0 +1,23 @@
+#ifndef LATENCY_STATS_H
+#define LATENCY_STATS_H
+
+#include <stdint.h>
+
+// === Latency stats ===
+// Ковзне вікно останніх вимірів і перцентилі за методом найближчого рангу.
+// Без залежностей від Arduino, тож можна перевірити на хості.
+#define LATENCY_WINDOW 64
+
+struct LatencyStats {
+  uint32_t samples[LATENCY_WINDOW] = {};
+  uint16_t count = 0;       // скільки вимірів у вікні
+  uint16_t head = 0;
+  uint32_t total = 0;       // за весь час, не лише у вікні
+
+  void reset();
+  void add(uint32_t value);
+  uint32_t percentile(uint8_t pct) const;
+  uint32_t maxValue() const;
+};
+
+#endif
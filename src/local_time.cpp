@@ -0,0 +1,225 @@
+#include "local_time.h"
+#include "app_config.h"
+#include <esp_timer.h>
+
+const time_t CLOCK_VALID_AFTER = 1577836800;   // 2020-01-01: раніше - годинник ще не синхронізовано
+
+// Правило ЄС (і України): літній час з 01:00 UTC останньої неділі березня
+// до 01:00 UTC останньої неділі жовтня. Моменти в UTC однакові для всіх поясів,
+// тож таблиця одна. Згенеровано скриптом на Python (calendar.timegm).
+static const uint32_t EU_DST_TRANSITIONS[] = {
+  1711846800UL, 1729990800UL,  // 2024: 31.03 - 27.10
+  1743296400UL, 1761440400UL,  // 2025: 30.03 - 26.10
+  1774746000UL, 1792890000UL,  // 2026: 29.03 - 25.10
+  1806195600UL, 1824944400UL,  // 2027: 28.03 - 31.10
+  1837645200UL, 1856394000UL,  // 2028: 26.03 - 29.10
+  1869094800UL, 1887843600UL,  // 2029: 25.03 - 28.10
+  1901149200UL, 1919293200UL,  // 2030: 31.03 - 27.10
+  1932598800UL, 1950742800UL,  // 2031: 30.03 - 26.10
+  1964048400UL, 1982797200UL,  // 2032: 28.03 - 31.10
+  1995498000UL, 2014246800UL,  // 2033: 27.03 - 30.10
+  2026947600UL, 2045696400UL,  // 2034: 26.03 - 29.10
+  2058397200UL, 2077146000UL,  // 2035: 25.03 - 28.10
+  2090451600UL, 2108595600UL,  // 2036: 30.03 - 26.10
+  2121901200UL, 2140045200UL,  // 2037: 29.03 - 25.10
+  2153350800UL, 2172099600UL,  // 2038: 28.03 - 31.10
+  2184800400UL, 2203549200UL,  // 2039: 27.03 - 30.10
+  2216250000UL, 2234998800UL,  // 2040: 25.03 - 28.10
+  2248304400UL, 2266448400UL,  // 2041: 31.03 - 27.10
+  2279754000UL, 2297898000UL,  // 2042: 30.03 - 26.10
+  2311203600UL, 2329347600UL,  // 2043: 29.03 - 25.10
+  2342653200UL, 2361402000UL,  // 2044: 27.03 - 30.10
+  2374102800UL, 2392851600UL,  // 2045: 26.03 - 29.10
+  2405552400UL, 2424301200UL,  // 2046: 25.03 - 28.10
+  2437606800UL, 2455750800UL,  // 2047: 31.03 - 27.10
+  2469056400UL, 2487200400UL,  // 2048: 29.03 - 25.10
+  2500506000UL, 2519254800UL,  // 2049: 28.03 - 31.10
+  2531955600UL, 2550704400UL,  // 2050: 27.03 - 30.10
+};
+static const int EU_DST_TRANSITION_COUNT = sizeof(EU_DST_TRANSITIONS) / sizeof(EU_DST_TRANSITIONS[0]);
+
+static const TimeZoneInfo ZONES[] = {
+  {"Europe/Kyiv", 2 * 3600, 3 * 3600},
+  {"Europe/Warsaw", 1 * 3600, 2 * 3600},
+  {"Europe/London", 0, 1 * 3600},
+  {"UTC", 0, 0},
+};
+static const int ZONE_COUNT = sizeof(ZONES) / sizeof(ZONES[0]);
+
+static int zoneIndex = 0;
+
+// Кеш: зміщення дійсне на проміжку [cacheFrom, cacheUntil). Беззнакові 32 біти,
+// щоб таблиця після 2038 року не ламалась там, де time_t ще 32-бітний
+static long cachedOffset = 0;
+static uint32_t cacheFrom = 1;
+static uint32_t cacheUntil = 0;
+
+static void invalidateCache() {
+  cacheFrom = 1;
+  cacheUntil = 0;
+}
+
+// Двійковий пошук першого переходу, пізнішого за utc; парна кількість пройдених - зимовий час
+static void refreshOffset(uint32_t utc) {
+  const TimeZoneInfo& zone = ZONES[zoneIndex];
+  int lo = 0;
+  int hi = EU_DST_TRANSITION_COUNT;
+  while (lo < hi) {
+    int mid = (lo + hi) / 2;
+    if (EU_DST_TRANSITIONS[mid] <= utc) lo = mid + 1;
+    else hi = mid;
+  }
+  bool dst = (lo % 2) == 1 && zone.dstOffsetS != zone.standardOffsetS;
+  cachedOffset = dst ? zone.dstOffsetS : zone.standardOffsetS;
+  cacheFrom = lo > 0 ? EU_DST_TRANSITIONS[lo - 1] : 0;
+  // Після кінця таблиці - зимовий час до оновлення прошивки
+  cacheUntil = lo < EU_DST_TRANSITION_COUNT ? EU_DST_TRANSITIONS[lo] : UINT32_MAX;
+}
+
+// === Civil clock state ===
+static const int64_t CLOCK_MAX_CATCHUP_US = 3600LL * 1000000LL; // довша перерва - прив'язуємось заново
+
+static bool clockValid = false;
+static uint32_t clockUtc = 0;
+static int64_t nextSecondUs = 0;
+static uint16_t minuteOfDay = 0;
+static uint8_t secondOfMinute = 0;
+static uint8_t weekday = 0;
+static int32_t dayNumber = 0;
+static uint32_t anchorCount = 0;
+static unsigned long lastProbeMs = 0;
+
+void localTimeBegin() {
+  zoneIndex = 0;
+  for (int i = 0; i < ZONE_COUNT; ++i) {
+    if (strcmp(appConfig.tzName, ZONES[i].name) == 0) zoneIndex = i;
+  }
+  invalidateCache();
+  localClockAnchor();
+}
+
+bool localTimeSetZone(const String& name, Preferences& preferences) {
+  for (int i = 0; i < ZONE_COUNT; ++i) {
+    if (name == ZONES[i].name) {
+      zoneIndex = i;
+      snprintf(appConfig.tzName, sizeof(appConfig.tzName), "%s", ZONES[i].name);
+      appConfigSave(preferences);
+      invalidateCache();
+      localClockAnchor();
+      return true;
+    }
+  }
+  return false;
+}
+
+const TimeZoneInfo& localTimeZone() {
+  return ZONES[zoneIndex];
+}
+
+long localUtcOffset(time_t utc) {
+  uint32_t u = utc > 0 ? static_cast<uint32_t>(utc) : 0;
+  if (u < cacheFrom || u >= cacheUntil) refreshOffset(u);
+  return cachedOffset;
+}
+
+// Єдине перетворення UTC -> місцевий час; решту часу годинник лише додає секунди
+void localClockAnchor() {
+  int64_t nowUs = esp_timer_get_time();
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  time_t utc = tv.tv_sec;
+  if (utc < CLOCK_VALID_AFTER) {
+    clockValid = false;
+    return;
+  }
+  // Прив'язуємось до межі секунди, щоб подальші кроки були рівно по 1 с
+  nextSecondUs = nowUs + (1000000 - tv.tv_usec);
+
+  // У беззнаковому 32-бітному вигляді, як і таблиця: без переповнення після 2038
+  uint32_t local = static_cast<uint32_t>(utc) + static_cast<int32_t>(localUtcOffset(utc));
+  uint32_t secondOfDay = local % 86400;
+  dayNumber = local / 86400;
+  minuteOfDay = secondOfDay / 60;
+  secondOfMinute = secondOfDay % 60;
+  weekday = (dayNumber + 4) % 7;   // 1970-01-01 - четвер
+  clockUtc = static_cast<uint32_t>(utc);
+  clockValid = true;
+  anchorCount++;
+}
+
+// O(1) на виклик: кожна секунда, що минула, - інкремент, без gmtime_r
+void localClockTick() {
+  if (!clockValid) {
+    if (millis() - lastProbeMs >= 1000) {
+      lastProbeMs = millis();
+      localClockAnchor();
+    }
+    return;
+  }
+  int64_t nowUs = esp_timer_get_time();
+  if (nowUs - nextSecondUs > CLOCK_MAX_CATCHUP_US) {
+    localClockAnchor();
+    return;
+  }
+  while (nowUs >= nextSecondUs) {
+    nextSecondUs += 1000000;
+    clockUtc++;
+    if (++secondOfMinute == 60) {
+      secondOfMinute = 0;
+      if (++minuteOfDay == 24 * 60) {
+        minuteOfDay = 0;
+        weekday = (weekday + 1) % 7;
+        dayNumber++;
+      }
+    }
+    // Перехід на літній/зимовий час: зміщення змінилось - прив'язуємось заново
+    if (clockUtc >= cacheUntil) {
+      localClockAnchor();
+      return;
+    }
+  }
+}
+
+bool localClockValid() {
+  return clockValid;
+}
+
+time_t localClockUtc() {
+  return clockValid ? static_cast<time_t>(clockUtc) : time(nullptr);
+}
+
+// Оцінка UTC з точністю до мікросекунди без звернення до системного годинника
+int64_t localClockUtcMicros() {
+  if (!clockValid) return 0;
+  return static_cast<int64_t>(clockUtc) * 1000000LL + (esp_timer_get_time() - (nextSecondUs - 1000000));
+}
+
+uint16_t localMinuteOfDay() {
+  return minuteOfDay;
+}
+
+uint8_t localSecond() {
+  return secondOfMinute;
+}
+
+uint8_t localWeekday() {
+  return weekday;
+}
+
+int32_t localDayNumber() {
+  return dayNumber;
+}
+
+uint32_t localClockAnchors() {
+  return anchorCount;
+}
+
+String localTimeZonesJson() {
+  String json = "[";
+  for (int i = 0; i < ZONE_COUNT; ++i) {
+    if (i > 0) json += ",";
+    json += "\"" + String(ZONES[i].name) + "\"";
+  }
+  json += "]";
+  return json;
+}
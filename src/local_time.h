@@ -0,0 +1,41 @@
+#ifndef LOCAL_TIME_H
+#define LOCAL_TIME_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <time.h>
+
+// === Local time ===
+// Часовий пояс із заздалегідь обчисленою таблицею переходів на літній час.
+// Поточне зміщення кешується і перераховується лише після чергового переходу.
+// Настінний годинник перетворюється з time() лише при прив'язці (старт, SNTP,
+// корекція дрейфу, перехід на літній час), далі хвилина доби і день тижня рахуються інкрементно
+// від esp_timer.
+struct TimeZoneInfo {
+  const char* name;
+  int32_t standardOffsetS;
+  int32_t dstOffsetS;       // == standardOffsetS, якщо літнього часу немає
+};
+
+extern const time_t CLOCK_VALID_AFTER;
+
+// === Local Time Functions ===
+void localTimeBegin();
+bool localTimeSetZone(const String& name, Preferences& preferences);
+const TimeZoneInfo& localTimeZone();
+long localUtcOffset(time_t utc);
+String localTimeZonesJson();
+
+// === Civil clock ===
+void localClockAnchor();
+void localClockTick();
+bool localClockValid();
+time_t localClockUtc();
+int64_t localClockUtcMicros();
+uint16_t localMinuteOfDay();
+uint8_t localSecond();
+uint8_t localWeekday();      // 0 - неділя, як tm_wday
+int32_t localDayNumber();    // місцевих діб від 1970-01-01
+uint32_t localClockAnchors();
+
+#endif
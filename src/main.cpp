@@ -5,16 +5,31 @@
 #include <ESPmDNS.h>
 #include "time.h"
 #include "esp_sleep.h"
+#include "esp_system.h"
 #include "esp_wifi.h"
 
 #include "wifi_manager.h"
-
-void configureBatteryAdc() {
-#if defined(ESP32) || defined(ARDUINO_ARCH_ESP32) || defined(CONFIG_IDF_TARGET_ESP32C3) || defined(CONFIG_IDF_TARGET_ESP32S3)
-  analogReadResolution(12);
-  analogSetAttenuation(ADC_11db);
-#endif
-}
+#include "servo_motion.h"
+#include "speed_model.h"
+#include "dosing.h"
+#include "current_sense.h"
+#include "battery.h"
+#include "battery_history.h"
+#include "battery_forecast.h"
+#include "power_profile.h"
+#include "idle_governor.h"
+#include "wifi_duty.h"
+#include "wifi_power.h"
+#include "button_input.h"
+#include "feed_catchup.h"
+#include "feed_schedule.h"
+#include "local_time.h"
+#include "time_keeper.h"
+#include "event_log.h"
+#include "feed_timing.h"
+#include "boot_profile.h"
+#include "app_config.h"
+#include <esp_timer.h>
 
 Servo mg996r;
 Preferences preferences;
@@ -25,37 +40,28 @@ WebServer server(80);
 const int SERVO_PIN = 4;
 const int BUTTON_PIN = 3;
 const int BATTERY_PIN = 2; // ⚡ MH Electronic Voltage Sensor (VOUT)
+const int SERVO_POWER_PIN = -1; // ключ живлення шини серво (-1 - не встановлено)
+const int CURRENT_SENSE_PIN = -1; // вихід датчика струму серво (-1 - не встановлено)
+const float STALL_BACKOFF_DEG = 15.0f;
 
 // === Servo / settings ===
 int minAngle = 0;
 int maxAngle = 180;
 float speedSetting = 20.0;
+int speedTenths = 200;        // speedSetting у десятих: на гарячому шляху лише цілі
 int currentAngle = 0;
 bool manualMoving = false;
-bool lastButtonState = HIGH;
+int64_t lastFeedFinishedUs = 0;  // натискання під час годування не ставлять ще одне
 
 // --- Автоматичне годування ---
-struct FeedTime {
-  int hour;
-  int minute;
-  int repeats;
-  bool done;
-};
-
-#define MAX_FEED_TIMES 20
-FeedTime feedTimes[MAX_FEED_TIMES];
-int feedTimesCount = 0;
-
-static constexpr long KIEV_UTC_OFFSET_SECONDS = 2 * 3600; // UTC+2. За потреби змініть на 3*3600.
+static_assert(MAX_FEED_TIMES <= CATCHUP_MAX_SLOTS, "catch-up state must cover every slot");
 
-unsigned long lastAutoFeedMillis = 0;
-bool autoFeedSleepPending = false;
 
 static inline bool isDigitChar(char c) {
   return c >= '0' && c <= '9';
 }
 
-int extractIntField(const String& obj, char fieldKey, int fallback) {
+static int findFieldValue(const String& obj, char fieldKey) {
   String pattern = "\"";
   pattern += fieldKey;
   pattern += "\":";
@@ -65,14 +71,15 @@ int extractIntField(const String& obj, char fieldKey, int fallback) {
     shortPattern += fieldKey;
     shortPattern += ":";
     pos = obj.indexOf(shortPattern);
-    if (pos == -1) return fallback;
+    if (pos == -1) return -1;
   }
 
   int colon = obj.indexOf(':', pos);
-  if (colon == -1) return fallback;
+  if (colon == -1) return -1;
 
+  const int length = obj.length();
   int valueStart = colon + 1;
-  while (valueStart < obj.length()) {
+  while (valueStart < length) {
     char c = obj.charAt(valueStart);
     if (c == ' ' || c == '\t' || c == '"' || c == '\'') {
       valueStart++;
@@ -80,7 +87,13 @@ int extractIntField(const String& obj, char fieldKey, int fallback) {
     }
     break;
   }
-  if (valueStart >= obj.length()) return fallback;
+  if (valueStart >= length) return -1;
+  return valueStart;
+}
+
+int extractIntField(const String& obj, char fieldKey, int fallback) {
+  int valueStart = findFieldValue(obj, fieldKey);
+  if (valueStart == -1) return fallback;
 
   bool negative = false;
   if (obj.charAt(valueStart) == '-') {
@@ -88,8 +101,9 @@ int extractIntField(const String& obj, char fieldKey, int fallback) {
     valueStart++;
   }
 
+  const int length = obj.length();
   int valueEnd = valueStart;
-  while (valueEnd < obj.length() && isDigitChar(obj.charAt(valueEnd))) {
+  while (valueEnd < length && isDigitChar(obj.charAt(valueEnd))) {
     valueEnd++;
   }
 
@@ -99,194 +113,281 @@ int extractIntField(const String& obj, char fieldKey, int fallback) {
   return value;
 }
 
+float extractFloatField(const String& obj, char fieldKey, float fallback) {
+  int valueStart = findFieldValue(obj, fieldKey);
+  if (valueStart == -1) return fallback;
+
+  const int length = obj.length();
+  int valueEnd = valueStart;
+  if (valueEnd < length && obj.charAt(valueEnd) == '-') valueEnd++;
+  while (valueEnd < length && (isDigitChar(obj.charAt(valueEnd)) || obj.charAt(valueEnd) == '.')) {
+    valueEnd++;
+  }
+
+  String number = obj.substring(valueStart, valueEnd);
+  if (number.length() == 0 || number == "-") return fallback;
+  return number.toFloat();
+}
+
 struct NextFeedInfo {
   int minutesUntil = -1;
   int targetHour = -1;
   int targetMinute = -1;
 };
 
-static const long DEFAULT_TIMEZONE_OFFSET_SECONDS = 2 * 3600; // UTC+2 (Київ, зимовий час)
-
-// Старі змінні для сумісності
-int feedHour1 = 10;
-int feedMinute1 = 0;
-int feedHour2 = 20;
-int feedMinute2 = 0;
-bool feed1Done = false;
-bool feed2Done = false;
-
 NextFeedInfo computeNextFeed() {
   NextFeedInfo info;
-  time_t now = time(nullptr);
-  struct tm localTime;
-  time_t adjusted = now + KIEV_UTC_OFFSET_SECONDS;
-  if (!gmtime_r(&adjusted, &localTime) || localTime.tm_year + 1900 < 2020) {
+  if (!localClockValid()) {
     return info;
   }
 
-  const int nowTotal = localTime.tm_hour * 60 + localTime.tm_min;
-  int bestDiff = (24 * 60) + 1;
-  bool found = false;
-
-  auto considerSlot = [&](int hour, int minute) {
-    if (hour < 0 || minute < 0) return;
-    hour = constrain(hour, 0, 23);
-    minute = constrain(minute, 0, 59);
-    int slotTotal = hour * 60 + minute;
-    int diff = slotTotal - nowTotal;
-    if (diff <= 0) diff += 24 * 60;
-    if (diff < bestDiff) {
-      bestDiff = diff;
-      info.minutesUntil = diff;
-      info.targetHour = hour;
-      info.targetMinute = minute;
-      found = true;
-    }
-  };
-
-  for (int i = 0; i < feedTimesCount; ++i) {
-    considerSlot(feedTimes[i].hour, feedTimes[i].minute);
-  }
-
-  if (!found) {
-    considerSlot(feedHour1, feedMinute1);
-    considerSlot(feedHour2, feedMinute2);
+  // Усі слоти неактивні (дні тижня, діапазон дат) - наступного годування немає
+  ScheduleNext next;
+  if (scheduleNext(localDayNumber(), localWeekday(), localMinuteOfDay(), next)) {
+    info.minutesUntil = next.minutesUntil;
+    info.targetHour = next.minuteOfDay / 60;
+    info.targetMinute = next.minuteOfDay % 60;
   }
-
   return info;
 }
 
 // --- Кількість повторів годування ---
 int feedRepeats = 1;
-int feedRepeats1 = 1;  // для першого годування
-int feedRepeats2 = 1;  // для другого годування
 
 // --- Режим економії енергії ---
 bool powerSaveMode = true;  // режим економії енергії
-unsigned long lastActivity = 0;
-const unsigned long ACTIVITY_TIMEOUT = 300000; // 5 хвилин бездіяльності
-const unsigned long SLEEP_INTERVAL = 60000;    // сон на 1 хвилину між перевірками
-
-// --- Напруга батареї ---
-float batteryVoltage = 0.0;
-float batteryPercent = 0.0;
-const int BATTERY_SAMPLES = 16;
-const float ADC_REFERENCE_VOLTAGE = 3.3f;
-const float ADC_MAX_VALUE = 4095.0f;
-const float VOLTAGE_DIVIDER_RATIO = 5.08f;   // розраховано під MH Electronic сенсор
-const float BATTERY_CALIBRATION = 0.58f;     // додаткова корекція (налаштувати за потреби)
-
-// === Utilities ===
-float readBatteryVoltage() {
-  uint32_t accumulator = 0;
-  for (int i = 0; i < BATTERY_SAMPLES; ++i) {
-    accumulator += analogRead(BATTERY_PIN);
-    delayMicroseconds(200);
-  }
-  float raw = accumulator / static_cast<float>(BATTERY_SAMPLES);
-  float voltage = (raw / ADC_MAX_VALUE) * ADC_REFERENCE_VOLTAGE * VOLTAGE_DIVIDER_RATIO;
-  voltage *= BATTERY_CALIBRATION;
-  return voltage;
-}
-
-float voltageToPercent(float v) {
-  // 2S Li-Ion: 8.4V ~ 100%, 6.6V ~ 0% (критично)
-  const float MAX_VOLTAGE = 8.4f;
-  const float MIN_VOLTAGE = 6.6f;
-
-  if (v >= MAX_VOLTAGE) return 100.0f;
-  if (v <= MIN_VOLTAGE) return 0.0f;
-
-  float percent = (v - MIN_VOLTAGE) / (MAX_VOLTAGE - MIN_VOLTAGE) * 100.0f;
-  if (percent < 0.0f) percent = 0.0f;
-  if (percent > 100.0f) percent = 100.0f;
-  return percent;
-}
-
-int speedToStepDelayMs(float sliderSpeed) {
-  float minSpeed = 19.5;
-  float maxSpeed = 20.0;
-  float normalized = (sliderSpeed - 1) / (20 - 1);
-  float realSpeed = minSpeed + normalized * (maxSpeed - minSpeed);
-  int stepDelay = (int)((20.0 - realSpeed) * 10);
-  return max(stepDelay, 0);
-}
-
 
 // === Power Management ===
-void enterLightSleep() {
+// Кнопка будить з light sleep, тож ручне годування не чекає кінця сну
+void enterLightSleep(uint64_t sleepUs) {
   Serial.println("Перехід у light sleep для економії енергії...");
-  esp_sleep_enable_timer_wakeup(SLEEP_INTERVAL * 1000); // пробудження через 1 хвилину
-  if (esp_light_sleep_start() == ESP_OK) {
+  batteryHistoryMark(HISTORY_SLEPT);
+  esp_sleep_enable_timer_wakeup(sleepUs);
+  buttonPrepareLightSleep();
+  PowerState previousState = powerStateEnter(POWER_LIGHT_SLEEP);
+  esp_err_t slept = esp_light_sleep_start();
+  powerStateRestore(previousState);
+  if (slept == ESP_OK) {
     Serial.println("Пробудження зі sleep");
   }
+  bool wokeByButton = esp_sleep_get_wakeup_cause() == ESP_SLEEP_WAKEUP_GPIO;
+  buttonAfterLightSleep(wokeByButton);
+  if (wokeByButton) idleNoteActivity();
 }
 
-void updateActivity() {
-  lastActivity = millis();
-  autoFeedSleepPending = false;
+// Після deep sleep - звичайне завантаження з setup(); розклад і налаштування в NVS, історія в RTC
+void enterDeepSleep(uint64_t sleepUs) {
+  Serial.printf("Deep sleep for %llu s\n", sleepUs / 1000000ULL);
+  batteryHistoryMark(HISTORY_SLEPT);
+  esp_sleep_enable_timer_wakeup(sleepUs);
+  buttonPrepareDeepSleep();
+  timeKeeperSave();
+  eventLogFlush();
+  WiFi.disconnect(true);
+  Serial.flush();
+  esp_deep_sleep_start();
 }
 
-bool isTimeForFeeding() {
-  time_t now = time(nullptr);
-  struct tm localTime;
-  time_t adjusted = now + KIEV_UTC_OFFSET_SECONDS;
-  if (!gmtime_r(&adjusted, &localTime) || localTime.tm_year + 1900 < 2020) {
-    return false;
-  }
-
-  int curHour = localTime.tm_hour;
-  int curMinute = localTime.tm_min;
-
-  if (feedTimesCount == 0) {
-    return (curHour == feedHour1 && curMinute == feedMinute1 && !feed1Done) ||
-           (curHour == feedHour2 && curMinute == feedMinute2 && !feed2Done);
-  }
-
-  for (int i = 0; i < feedTimesCount; ++i) {
-    if (curHour == feedTimes[i].hour && curMinute == feedTimes[i].minute && !feedTimes[i].done) {
-      return true;
-    }
+void updateActivity() {
+  idleNoteActivity();
+}
+
+// Утримання позиції (servoSettleMs=0) сну не блокує: інакше плата не засинала б ніколи.
+// Сон знімає утримання - ШІМ стоїть у light sleep, шина серво вимкнена в deep sleep
+void runIdleGovernor() {
+  bool busy = !powerSaveMode || manualMoving || isAPMode || motionIsMoving();
+  NextFeedInfo nextInfo = computeNextFeed();
+  long secondsUntilFeed = nextInfo.minutesUntil > 0 ? static_cast<long>(nextInfo.minutesUntil) * 60L : -1;
+  wifiDutyTick(secondsUntilFeed);
+
+  // Прокидаємось до найближчої події: годування або вікна зв'язку
+  long secondsUntilWake = wifiDutySecondsUntilWindow(secondsUntilFeed);
+  IdleLevel level = idleGovernorDecide(busy, secondsUntilWake);
+  wifiPowerSetIdle(level != IDLE_ACTIVE);
+  uint64_t sleepUs = idleSleepMicros(level, secondsUntilWake);
+  if (sleepUs == 0) return;
+  if (level == IDLE_DEEP_SLEEP) {
+    enterDeepSleep(sleepUs);
+  } else if (level == IDLE_LIGHT_SLEEP) {
+    Serial.printf("Idle %lu s, next wake event in %ld s: light sleep\n", idleForMs() / 1000, secondsUntilWake);
+    enterLightSleep(sleepUs);
   }
-  return false;
 }
 
-void moveServoSmooth(int target) {
-  target = constrain(target, 0, 180);
-  if (target == currentAngle) return;
-  int stepDelay = speedToStepDelayMs(speedSetting);
-  if (target > currentAngle) {
-    for (int a = currentAngle + 1; a <= target; ++a) { mg996r.write(a); delay(stepDelay); }
-  } else {
-    for (int a = currentAngle - 1; a >= target; --a) { mg996r.write(a); delay(stepDelay); }
+// Повертає false при заклинюванні: фіксуємо подію і трохи відводимо вал назад
+bool moveServoSmooth(float target) {
+  target = constrain(target, 0.0f, 180.0f);
+  const float from = motionCurrentAngle();
+  if (fabsf(target - from) < 0.05f) return true;   // вже на місці: без живлення і attach серво
+  const float dps = commandedDegreesPerSecond(sliderToDegreesPerSecond(speedTenths));
+  bool completed = motionMoveTo(target, dps);
+  if (!completed) {
+    float stalledAt = motionCurrentAngle();
+    recordFault(FAULT_STALL, stalledAt);
+    float direction = target > from ? 1.0f : -1.0f;
+    motionMoveTo(stalledAt - direction * STALL_BACKOFF_DEG, dps);
   }
-  currentAngle = target;
+  currentAngle = static_cast<int>(motionCurrentAngle() + 0.5f);
+  return completed;
 }
 
 void moveServoFast(int target) {
   target = constrain(target, 0, 180);
-  mg996r.write(target);
+  motionJumpTo(target);
   currentAngle = target;
 }
 
-void feedSequence(int repeats = 1) {
+// travelDeg < 0 - повний хід minAngle -> maxAngle
+void feedSequence(EventSource source, int repeats = 1, float travelDeg = -1.0f) {
   manualMoving = true;
+  feedTimingStart(source);
+  eventLogAppend(EVENT_FEED_START, source, constrain(repeats, 0, 255),
+                 static_cast<uint16_t>(min(readBatteryMillivolts(), static_cast<uint32_t>(65535))));
+  int64_t startedUs = esp_timer_get_time();
+  int faultsBefore = faultCount();
+  batteryHistoryMark(HISTORY_SERVO_ACTIVE);
+  PowerState previousState = powerStateEnter(POWER_SERVO);
+  float sweepTarget = maxAngle;
+  if (travelDeg >= 0.0f) {
+    float direction = maxAngle >= minAngle ? 1.0f : -1.0f;
+    float fullTravel = abs(maxAngle - minAngle);
+    sweepTarget = minAngle + direction * min(travelDeg, fullTravel);
+  }
   for (int i = 0; i < repeats; i++) {
-    moveServoSmooth(minAngle);
+    if (!moveServoSmooth(minAngle)) break;
     delay(50);
-    moveServoSmooth(maxAngle);
+    if (!moveServoSmooth(sweepTarget)) break;
     delay(50);
-    moveServoSmooth(minAngle);
+    if (!moveServoSmooth(minAngle)) break;
     delay(50);
   }
+  powerStateRestore(previousState);
+  lastFeedFinishedUs = esp_timer_get_time();
+  // Заклинювання фіксує moveServoSmooth() через recordFault()
+  eventLogAppend(EVENT_FEED_END, source, faultCount() == faultsBefore ? 1 : 0,
+                 static_cast<uint16_t>(min((lastFeedFinishedUs - startedUs) / 10000, static_cast<int64_t>(65535))));
+  feedTimingFinish();
   manualMoving = false;
 }
 
-void performAutoFeeding(int repeats) {
-  feedSequence(repeats);
-  if (powerSaveMode) {
-    lastAutoFeedMillis = millis();
-    autoFeedSleepPending = true;
+// Дозування за масою: якщо є калібрування бункера, рахуємо мінімум ходів і кут
+void feedDose(EventSource source, int repeats, float grams) {
+  if (grams > 0.0f) {
+    DosePlan plan = planDose(grams, abs(maxAngle - minAngle));
+    if (plan.sweeps > 0) {
+      Serial.printf("Dose %.1f g -> %d sweeps x %.1f deg (~%.1f g)\n",
+                    grams, plan.sweeps, plan.travelDeg, plan.expectedGrams);
+      // API такі дози відхиляє; сюди доходять лише після перекалібрування бункера
+      if (plan.capped) {
+        float shortGrams = grams - plan.expectedGrams;
+        Serial.printf("Dose capped at %d sweeps, %.1f g short\n", plan.sweeps, shortGrams);
+        eventLogAppend(EVENT_DOSE_CAPPED, source, plan.sweeps,
+                       static_cast<uint16_t>(constrain(lroundf(shortGrams * 10.0f), 0L, 65535L)));
+      }
+      feedSequence(source, plan.sweeps, plan.travelDeg);
+      return;
+    }
+    Serial.println("Dose requested, but hopper is not calibrated; using repeats");
+  }
+  feedSequence(source, repeats);
+}
+
+// Вартість розкладу для прогнозу батареї: перераховуємо лише при зміні налаштувань
+void updateForecastSchedule() {
+  const float travel = abs(maxAngle - minAngle);
+  const float dps = sliderToDegreesPerSecond(speedTenths);
+  float feedMah = 0.0f;
+  float feedsPerDay = 0.0f;
+  for (int i = 0; i < feedTimesCount; ++i) {
+    int sweeps = feedTimes[i].repeats;
+    float sweepTravel = travel;
+    if (feedTimes[i].gramsTenths > 0) {
+      DosePlan plan = planDose(feedGrams(feedTimes[i]), travel);
+      if (plan.sweeps > 0) {
+        sweeps = plan.sweeps;
+        sweepTravel = plan.travelDeg;
+      }
+    }
+    // Слоти не щоденні: у добовий бюджет - середня частка днів
+    const float perDay = feedDaysPerDay(feedTimes[i]);
+    feedMah += perDay * estimateFeedEnergyMah(estimateFeedMs(sweeps, sweepTravel, dps));
+    feedsPerDay += perDay;
+  }
+  int dailyFeeds = static_cast<int>(lroundf(feedsPerDay));
+  int wakes = powerSaveMode ? dailyFeeds : 0;
+  int feedSessions = 0;
+  int checkInSessions = 0;
+  if (wifiDutyConfig.enabled) {
+    feedSessions = dailyFeeds;
+    if (wifiDutyConfig.checkInMin > 0) checkInSessions = 24 * 60 / wifiDutyConfig.checkInMin;
+  }
+  batteryForecastSetSchedule(feedMah, wakes, feedSessions, checkInSessions);
+}
+
+// Черга з кнопки; натискання, що прийшли під час годування, відкидаються
+void runMotionJob(const MotionJob& job) {
+  if (job.kind != MOTION_JOB_FEED || job.queuedUs < lastFeedFinishedUs) return;
+  Serial.printf("Button feed, queued %lld us ago\n", static_cast<long long>(esp_timer_get_time() - job.queuedUs));
+  idleNoteActivity();
+  feedSequence(EVENT_SOURCE_BUTTON);
+}
+
+void performAutoFeeding(EventSource source, int repeats, float grams = 0.0f) {
+  feedDose(source, repeats, grams);
+  idleNoteFeedDone();
+}
+
+// Один прохід по всіх слотах: вчасні годуємо, пропущені (сон, перезавантаження,
+// довге підключення до Wi-Fi) - згідно з політикою catch-up
+void runSchedulePass(time_t now) {
+  int toFeed[MAX_FEED_TIMES];
+  EventSource toFeedSource[MAX_FEED_TIMES];
+  time_t toFeedAt[MAX_FEED_TIMES];
+  int toFeedCount = 0;
+  int missedCount = 0;
+  int latestMissed = -1;
+  time_t latestMissedAt = 0;
+
+  for (int i = 0; i < feedTimesCount; ++i) {
+    time_t occurrence = scheduleLastOccurrence(i, now, localUtcOffset(now));
+    if (occurrence == 0) continue;
+    SlotDue due = catchupClassify(i, occurrence, now);
+    if (due == SLOT_NOT_DUE) continue;
+    catchupMarkRun(i, occurrence);
+    if (due == SLOT_ON_TIME) {
+      toFeedSource[toFeedCount] = EVENT_SOURCE_SCHEDULE;
+      toFeedAt[toFeedCount] = occurrence;
+      toFeed[toFeedCount++] = i;
+    } else if (due == SLOT_MISSED) {
+      missedCount++;
+      if (catchupPolicy == CATCHUP_ALL) {
+        toFeedSource[toFeedCount] = EVENT_SOURCE_CATCHUP;
+        toFeedAt[toFeedCount] = occurrence;
+        toFeed[toFeedCount++] = i;
+      } else if (catchupPolicy == CATCHUP_ONCE && (latestMissed < 0 || occurrence > latestMissedAt)) {
+        latestMissed = i;
+        latestMissedAt = occurrence;
+      }
+    }
+  }
+  if (latestMissed >= 0) {
+    toFeedSource[toFeedCount] = EVENT_SOURCE_CATCHUP;
+    toFeedAt[toFeedCount] = latestMissedAt;
+    toFeed[toFeedCount++] = latestMissed;
+  }
+
+  // Фіксуємо до руху: просадка живлення посеред годування не повинна дати повторне годування
+  catchupSave();
+
+  if (missedCount > 0) {
+    Serial.printf("Catch-up: %d missed slot(s), policy %s\n", missedCount, catchupPolicyName(catchupPolicy));
+  }
+  for (int k = 0; k < toFeedCount; ++k) {
+    const FeedTime& slot = feedTimes[toFeed[k]];
+    Serial.printf("Auto feeding (slot %d) %02d:%02d, repeats: %d, grams: %.1f\n",
+                  toFeed[k] + 1, feedHour(slot), feedMinute(slot), slot.repeats, feedGrams(slot));
+    feedTimingExpect(static_cast<uint32_t>(toFeedAt[k]));
+    performAutoFeeding(toFeedSource[k], slot.repeats, feedGrams(slot));
   }
 }
 
@@ -413,6 +514,8 @@ h2 {
 }
 .flex-row span {font-weight: 500; color: #555; font-size: 12px;}
 .flex-row input, .flex-row select {width: auto; min-width: 60px; font-size: 12px;}
+.day-toggle {display: inline-flex; align-items: center; font-weight: 500; font-size: 12px; color: #555; margin: 0 4px 0 0;}
+.day-toggle input {min-width: 0; margin-right: 2px;}
 .toast {
   position: fixed;
   top: 20px;
@@ -805,10 +908,12 @@ body {
     <input id="angleSlider" type="range" min="0" max="180" value="0">
   </div>
   <div class="row">
-    <label>Швидкість серво: <span id="speedValue">20</span></label>
+    <label>Швидкість серво: <span id="speedValue">20</span> <span id="speedDps" style="font-weight:400; color:#6b7280;"></span></label>
     <input id="speedSlider" type="range" min="1" max="20" step="0.1" value="20" oninput="updateSpeed(this.value)">
   </div>
+  <div class="note-text" id="feedDurationNote"></div>
   <button onclick="saveSpeed()">Зберегти швидкість</button>
+  <button class="add-btn" onclick="calibrateSpeed()">Калібрувати швидкість</button>
 </div>
 
 <div class="card">
@@ -868,15 +973,6 @@ document.getElementById('angleSlider').addEventListener('input', function(){
   fetch('/api/setAngle?angle='+val);
 });
 
-function voltageToPercentClient(v) {
-  const MAX_VOLTAGE = 8.4;
-  const MIN_VOLTAGE = 6.6;
-  if (!Number.isFinite(v)) return null;
-  if (v >= MAX_VOLTAGE) return 100;
-  if (v <= MIN_VOLTAGE) return 0;
-  return Math.round(((v - MIN_VOLTAGE) / (MAX_VOLTAGE - MIN_VOLTAGE)) * 100);
-}
-
 function showToast(text = 'Збережено') {
   const toast = document.getElementById('toast');
   toast.innerText = text;
@@ -888,6 +984,13 @@ function showToast(text = 'Збережено') {
 
 function feedNow(){ fetch('/api/feedNow').then(()=>{statusUpdate(); showToast('Годую');}); }
 function saveSpeed(){ const s=document.getElementById('speedSlider').value; fetch('/api/setSpeed?speed='+s).then(()=>{statusUpdate(); showToast('Збережено');}); }
+function calibrateSpeed(){
+  showToast('Калібрування (~30 с)...');
+  fetch('/api/calibrateSpeed').then(r=>{
+    if (!r.ok) { r.text().then(t=>showToast(t)); return; }
+    setTimeout(statusUpdate, 35000);
+  });
+}
 function saveRepeats(){ const r=document.getElementById('feedRepeats').value; fetch('/api/setRepeats?repeats='+r).then(()=>{statusUpdate(); showToast();}); }
 function scanWiFi(){
   showToast('Сканування мереж...');
@@ -960,10 +1063,25 @@ function saveWiFi(){
     });
 }
 let feedTimeCounter = 0;
+// Тиждень з понеділка; біт у масці - як tm_wday (0 - неділя)
+const FEED_DAYS = [['Пн', 1], ['Вт', 2], ['Ср', 3], ['Чт', 4], ['Пт', 5], ['Сб', 6], ['Нд', 0]];
+const OPEN_END_DAY = 65535;
+
+function dayToDate(day) {
+  return day > 0 && day < OPEN_END_DAY ? new Date(day * 86400000).toISOString().slice(0, 10) : '';
+}
+
+function dateToDay(value, fallback) {
+  const ms = Date.parse(value);
+  return Number.isFinite(ms) ? Math.floor(ms / 86400000) : fallback;
+}
 
-function addFeedTime(hour = 10, minute = 0, repeats = 1) {
+function addFeedTime(hour = 10, minute = 0, repeats = 1, grams = 0, weekdays = 127, every = 1, fromDay = 0, toDay = OPEN_END_DAY) {
   const container = document.getElementById('feedTimesContainer');
   const blockId = 'feedBlock_' + feedTimeCounter++;
+  const dayToggles = FEED_DAYS.map(([label, bit]) =>
+    `<label class="day-toggle"><input type="checkbox" class="feed-day" data-bit="${bit}" ${weekdays & (1 << bit) ? 'checked' : ''}>${label}</label>`
+  ).join('');
   const block = document.createElement('div');
   block.className = 'feed-block';
   block.id = blockId;
@@ -975,8 +1093,19 @@ function addFeedTime(hour = 10, minute = 0, repeats = 1) {
       <input type="number" class="feed-minute" min="0" max="59" value="${minute}" style="width:35px; min-width:35px; padding: 4px;">
       <span>Повторів:</span>
       <input type="number" class="feed-repeats" min="1" max="20" value="${repeats}" style="width:35px; min-width:35px; padding: 4px;">
+      <span>Г:</span>
+      <input type="number" class="feed-grams" min="0" max="500" step="0.1" value="${grams}" title="0 - за кількістю повторів" style="width:45px; min-width:45px; padding: 4px;">
       <button class="remove-btn" onclick="removeFeedTime('${blockId}')" title="Видалити">×</button>
     </div>
+    <div class="flex-row">${dayToggles}</div>
+    <div class="flex-row">
+      <span>Кожні</span>
+      <input type="number" class="feed-every" min="1" max="30" value="${every}" style="width:35px; min-width:35px; padding: 4px;">
+      <span>дн., з</span>
+      <input type="date" class="feed-from" value="${dayToDate(fromDay)}" style="padding: 4px;">
+      <span>по</span>
+      <input type="date" class="feed-to" value="${dayToDate(toDay)}" style="padding: 4px;">
+    </div>
   `;
   container.appendChild(block);
 }
@@ -993,7 +1122,13 @@ function saveFeedTimes(){
     const hour = block.querySelector('.feed-hour').value;
     const minute = block.querySelector('.feed-minute').value;
     const repeats = block.querySelector('.feed-repeats').value;
-    feedTimes.push({h: hour, m: minute, r: repeats});
+    const grams = block.querySelector('.feed-grams').value || 0;
+    let weekdays = 0;
+    block.querySelectorAll('.feed-day').forEach(cb => { if (cb.checked) weekdays |= 1 << Number(cb.dataset.bit); });
+    const every = block.querySelector('.feed-every').value || 1;
+    const fromDay = dateToDay(block.querySelector('.feed-from').value, 0);
+    const toDay = dateToDay(block.querySelector('.feed-to').value, OPEN_END_DAY);
+    feedTimes.push({h: hour, m: minute, r: repeats, g: grams, w: weekdays, n: every, s: fromDay, e: toDay});
   });
   const data = JSON.stringify(feedTimes);
   fetch('/api/setFeedTimes?data=' + encodeURIComponent(data)).then(()=>{statusUpdate(); showToast();});
@@ -1005,7 +1140,8 @@ function loadFeedTimes(feedTimes) {
   container.innerHTML = '';
   if (feedTimes && feedTimes.length > 0) {
     feedTimes.forEach(ft => {
-      addFeedTime(ft.h || ft.hour || 10, ft.m || ft.minute || 0, ft.r || ft.repeats || 1);
+      addFeedTime(ft.h || ft.hour || 10, ft.m || ft.minute || 0, ft.r || ft.repeats || 1, ft.g || 0,
+                  ft.w !== undefined ? ft.w : 127, ft.n || 1, ft.s || 0, ft.e !== undefined ? ft.e : OPEN_END_DAY);
     });
   } else {
     addFeedTime(10, 0, 1);
@@ -1041,22 +1177,6 @@ function normalizeFeedSchedule(status) {
     });
   }
 
-  if (!schedule.length && status.feedHour1 !== undefined && status.feedMinute1 !== undefined) {
-    const h1 = Number(status.feedHour1);
-    const m1 = Number(status.feedMinute1);
-    const h2 = Number(status.feedHour2);
-    const m2 = Number(status.feedMinute2);
-    if (!isNaN(h1) && !isNaN(m1)) {
-      const normHour = ((h1 % 24) + 24) % 24;
-      const normMinute = ((m1 % 60) + 60) % 60;
-      schedule.push({ hour: normHour, minute: normMinute, total: normHour * 60 + normMinute });
-    }
-    if (!isNaN(h2) && !isNaN(m2)) {
-      const normHour = ((h2 % 24) + 24) % 24;
-      const normMinute = ((m2 % 60) + 60) % 60;
-      schedule.push({ hour: normHour, minute: normMinute, total: normHour * 60 + normMinute });
-    }
-  }
   schedule.sort((a, b) => a.total - b.total);
   return schedule;
 }
@@ -1182,8 +1302,15 @@ function updateBatteryGauge(percent) {
   }
 }
 
+// Час відповіді на попередній запит: прошивка веде перцентилі для кожного Wi-Fi профілю
+let lastStatusRtt = 0;
+let clockSentFromBrowser = false;
 function statusUpdate(){
-  fetch('/api/status').then(r=>r.json()).then(j=>{
+  const started = performance.now();
+  fetch('/api/status' + (lastStatusRtt ? '?rtt=' + lastStatusRtt : '')).then(r=>{
+    lastStatusRtt = Math.round(performance.now() - started);
+    return r.json();
+  }).then(j=>{
     const batteryVoltageEl = document.getElementById('batteryVoltage');
     if (batteryVoltageEl) {
       if (typeof j.batteryVoltage === 'number' && Number.isFinite(j.batteryVoltage)) {
@@ -1201,19 +1328,17 @@ function statusUpdate(){
         timeLabel.innerText = 'Час: --:--';
       }
     }
+    // Без NTP (режим AP, немає мережі) підводимо годинник за телефоном
+    if (!clockSentFromBrowser && j.clock && j.clock.source !== 'ntp') {
+      clockSentFromBrowser = true;
+      const nowMs = Date.now();
+      fetch('/api/setTime?epoch=' + Math.floor(nowMs / 1000) + '&ms=' + (nowMs % 1000));
+    }
 
     let batteryPercentValue = null;
-    if (typeof j.batteryVoltage === 'number' || typeof j.batteryVoltage === 'string') {
-      const computed = voltageToPercentClient(Number(j.batteryVoltage));
-      if (Number.isFinite(computed)) {
-        batteryPercentValue = computed;
-      }
-    }
-    if (batteryPercentValue === null) {
-      const rawPercent = Number(j.batteryPercent);
-      if (Number.isFinite(rawPercent)) {
-        batteryPercentValue = Math.round(rawPercent);
-      }
+    const rawPercent = Number(j.batteryPercent);
+    if (Number.isFinite(rawPercent)) {
+      batteryPercentValue = Math.round(rawPercent);
     }
     if (batteryPercentValue !== null) {
       updateBatteryGauge(Math.max(0, Math.min(100, batteryPercentValue)));
@@ -1223,6 +1348,13 @@ function statusUpdate(){
     updateNextFeedingProgress(j);
     document.getElementById('angleSlider').value=j.currentAngle; updateAngleLabel(j.currentAngle);
     document.getElementById('speedSlider').value=j.speed; updateSpeed(j.speed);
+    if (typeof j.speedDps === 'number') {
+      document.getElementById('speedDps').innerText = '(' + j.speedDps + ' °/с' + (j.speedCalibrated ? '' : ', без калібрування') + ')';
+    }
+    if (typeof j.feedDurationMs === 'number') {
+      document.getElementById('feedDurationNote').innerText =
+        'Годування: ~' + (j.feedDurationMs / 1000).toFixed(1) + ' с, ~' + Number(j.feedEnergyMah).toFixed(2) + ' мА·год';
+    }
     document.getElementById('feedRepeats').value=j.feedRepeats;
     const wifiSSIDInput = document.getElementById('wifiSSID');
     if(wifiSSIDInput && j.wifiSSID) {
@@ -1246,12 +1378,6 @@ function statusUpdate(){
     // Завантажуємо динамічні годування
     if (j.feedTimes) {
       loadFeedTimes(j.feedTimes);
-    } else if (j.feedHour1 !== undefined) {
-      // Сумісність зі старим форматом
-      loadFeedTimes([
-        {h: j.feedHour1, m: j.feedMinute1, r: j.feedRepeats1 || 1},
-        {h: j.feedHour2, m: j.feedMinute2, r: j.feedRepeats2 || 1}
-      ]);
     }
   });
 }
@@ -1351,6 +1477,11 @@ h2 {
   color: #333;
   text-align: right;
 }
+.history-chart {
+  width: 100%;
+  height: 140px;
+  margin-top: 8px;
+}
 .section-header {
   display: flex;
   align-items: flex-start;
@@ -1437,6 +1568,14 @@ a {
     <span class="info-label">Режим:</span>
     <span class="info-value" id="infoMode">завантаження...</span>
   </div>
+  <div class="info-row">
+    <span class="info-label">Часовий пояс:</span>
+    <span class="info-value" id="infoTimezone">завантаження...</span>
+  </div>
+  <div class="info-row">
+    <span class="info-label">Годинник:</span>
+    <span class="info-value" id="infoClock">завантаження...</span>
+  </div>
   <div class="info-row">
     <span class="info-label">mDNS:</span>
     <span class="info-value">fish.local</span>
@@ -1465,6 +1604,11 @@ a {
     <span class="info-label">Відсоток:</span>
     <span class="info-value" id="infoPercent">завантаження...</span>
   </div>
+  <div class="info-row">
+    <span class="info-label">Прогноз роботи:</span>
+    <span class="info-value" id="infoForecast">завантаження...</span>
+  </div>
+  <canvas id="historyChart" class="history-chart"></canvas>
 </div>
 
 <div class="card">
@@ -1499,6 +1643,21 @@ a {
     <span class="info-label">Режим економії:</span>
     <span class="info-value" id="infoPowerSave">завантаження...</span>
   </div>
+  <div class="info-row">
+    <span class="info-label">Wi-Fi профіль:</span>
+    <span class="info-value">
+      <select id="infoWifiProfile" onchange="setWifiProfile(this.value)" style="width:auto">
+        <option value="maxPerformance">Швидкий</option>
+        <option value="balanced">Збалансований</option>
+        <option value="minModem">Економний</option>
+      </select>
+      <span id="infoWifiLatency"></span>
+    </span>
+  </div>
+  <div class="info-row">
+    <span class="info-label">Відключення серво:</span>
+    <span class="info-value" id="infoServoSaved">завантаження...</span>
+  </div>
   <div class="info-row">
     <span class="info-label">Кількість розкладів:</span>
     <span class="info-value" id="infoSchedules">завантаження...</span>
@@ -1534,29 +1693,51 @@ a {
 </div>
 
 <script>
+let lastInfoRtt = 0;
 function updateInfo(){
-  fetch('/api/status').then(r=>r.json()).then(j=>{
+  const started = performance.now();
+  fetch('/api/status' + (lastInfoRtt ? '?rtt=' + lastInfoRtt : '')).then(r=>{
+    lastInfoRtt = Math.round(performance.now() - started);
+    return r.json();
+  }).then(j=>{
     document.getElementById('infoSSID').innerText = j.wifiSSID || 'не налаштовано';
     document.getElementById('infoIP').innerText = j.wifiIP || 'не підключено';
     document.getElementById('infoMode').innerText = j.isAPMode ? 'Точка доступу (AP)' : 'Станція (STA)';
+    if (j.timezone) {
+      const offsetH = Number(j.utcOffsetMin) / 60;
+      document.getElementById('infoTimezone').innerText = j.timezone + ' (UTC' + (offsetH >= 0 ? '+' : '') + offsetH + ')';
+    }
+    if (j.clock) {
+      const sources = {ntp: 'NTP', browser: 'з браузера', restored: 'відновлено', rtc: 'RTC', none: 'не встановлено'};
+      document.getElementById('infoClock').innerText = (sources[j.clock.source] || j.clock.source) +
+        ', дрейф ' + Number(j.clock.driftPpm).toFixed(1) + ' ppm';
+    }
     if (typeof j.batteryVoltage === 'number' && Number.isFinite(j.batteryVoltage)) {
       document.getElementById('infoVoltage').innerText = j.batteryVoltage.toFixed(2) + ' В';
     } else {
       document.getElementById('infoVoltage').innerText = '-- В';
     }
     const infoPercentEl = document.getElementById('infoPercent');
-    let infoPercentVal = voltageToPercentClient(Number(j.batteryVoltage));
-    if (!Number.isFinite(infoPercentVal)) {
-      infoPercentVal = Number(j.batteryPercent);
-    }
+    const infoPercentVal = Number(j.batteryPercent);
     if (Number.isFinite(infoPercentVal)) {
       infoPercentEl.innerText = Math.round(infoPercentVal) + '%';
     } else {
       infoPercentEl.innerText = '--%';
     }
+    const forecastEl = document.getElementById('infoForecast');
+    if (typeof j.daysRemaining === 'number' && j.daysRemaining >= 0) {
+      forecastEl.innerText = '~' + j.daysRemaining.toFixed(1) + ' дн. (' + Number(j.dailyMah).toFixed(0) + ' мА·год/добу)';
+    } else {
+      forecastEl.innerText = '--';
+    }
     document.getElementById('infoSpeed').innerText = j.speed;
     document.getElementById('infoRepeats').innerText = j.feedRepeats;
     document.getElementById('infoPowerSave').innerText = j.powerSaveMode ? 'Увімкнено' : 'Вимкнено';
+    if (typeof j.servoSettleMs === 'number') {
+      document.getElementById('infoServoSaved').innerText = j.servoSettleMs > 0
+        ? 'через ' + j.servoSettleMs + ' мс, заощаджено ' + Number(j.servoEnergySavedMah).toFixed(2) + ' мА·год'
+        : 'вимкнено';
+    }
     if(j.feedTimes) {
       document.getElementById('infoSchedules').innerText = j.feedTimes.length;
     } else {
@@ -1571,6 +1752,78 @@ function updateInfo(){
   });
 }
 
+// Бінарна історія батареї: varint N, далі N x [zigzag Δt, zigzag Δмв, прапорці]
+function decodeBatteryHistory(buf) {
+  const bytes = new Uint8Array(buf);
+  let pos = 0;
+  function varint() {
+    let result = 0, shift = 0, b;
+    do {
+      b = bytes[pos++];
+      result += (b & 0x7F) * Math.pow(2, shift);
+      shift += 7;
+    } while (b & 0x80);
+    return result;
+  }
+  function zigzag(v) { return (v % 2) ? -(v + 1) / 2 : v / 2; }
+  const count = varint();
+  const points = [];
+  let t = 0, mv = 0;
+  for (let i = 0; i < count && pos < bytes.length; i++) {
+    t += zigzag(varint());
+    mv += zigzag(varint());
+    const flags = bytes[pos++];
+    points.push({t, mv, flags});
+  }
+  return points;
+}
+
+function drawBatteryHistory(points) {
+  const canvas = document.getElementById('historyChart');
+  if (!canvas || points.length < 2) return;
+  const w = canvas.width = canvas.clientWidth * 2;
+  const h = canvas.height = canvas.clientHeight * 2;
+  const ctx = canvas.getContext('2d');
+  const t0 = points[0].t, t1 = points[points.length - 1].t;
+  let vMin = Math.min(...points.map(p => p.mv)), vMax = Math.max(...points.map(p => p.mv));
+  if (vMax - vMin < 100) { vMin -= 50; vMax += 50; }
+  const x = p => (p.t - t0) / Math.max(t1 - t0, 1) * (w - 8) + 4;
+  const y = p => h - 4 - (p.mv - vMin) / (vMax - vMin) * (h - 8);
+  ctx.clearRect(0, 0, w, h);
+  ctx.fillStyle = 'rgba(25,118,210,0.15)';
+  points.forEach(p => { if (p.flags & 1) ctx.fillRect(x(p) - 2, 0, 4, h); });
+  ctx.strokeStyle = '#1976D2';
+  ctx.lineWidth = 3;
+  ctx.beginPath();
+  points.forEach((p, i) => i ? ctx.lineTo(x(p), y(p)) : ctx.moveTo(x(p), y(p)));
+  ctx.stroke();
+  ctx.fillStyle = '#6b7280';
+  ctx.font = '20px sans-serif';
+  ctx.fillText((vMax / 1000).toFixed(2) + ' В', 8, 22);
+  ctx.fillText((vMin / 1000).toFixed(2) + ' В', 8, h - 8);
+}
+
+function updateWifiPower() {
+  fetch('/api/wifiPower').then(r => r.json()).then(j => {
+    document.getElementById('infoWifiProfile').value = j.profile;
+    const current = (j.profiles || []).find(p => p.name === j.profile);
+    document.getElementById('infoWifiLatency').innerText = current && current.samples > 0
+      ? ' p50 ' + current.p50Ms + ' / p90 ' + current.p90Ms + ' мс'
+      : '';
+  }).catch(() => {});
+}
+
+function setWifiProfile(profile) {
+  fetch('/api/setWifiPower?profile=' + profile).then(() => setTimeout(updateWifiPower, 3000));
+}
+
+function updateHistory() {
+  fetch('/api/history/battery?points=120')
+    .then(r => r.arrayBuffer())
+    .then(buf => drawBatteryHistory(decodeBatteryHistory(buf)))
+    .catch(() => {});
+}
+
 // Простий лічильник часу (приблизний)
 let startTime = Date.now();
 function millis() {
@@ -1579,7 +1832,10 @@ function millis() {
 
 window.onload = function() {
   updateInfo();
+  updateHistory();
+  updateWifiPower();
   setInterval(updateInfo, 10000);
+  setInterval(updateWifiPower, 60000);
 };
 </script>
 </body>
@@ -1598,16 +1854,44 @@ void handleRoot(){
 void handleInfo(){ server.send(200,"text/html",pageInfo); }
 
 void handleStatus(){
-  batteryVoltage = readBatteryVoltage();
-  batteryPercent = voltageToPercent(batteryVoltage);
+  // Браузер повідомляє, скільки йшла відповідь на попередній запит
+  if (server.hasArg("rtt")) wifiPowerRecordLatency(server.arg("rtt").toInt());
+  uint32_t batteryUnits = readBatteryUnits();
+  batteryMillivolts = batteryUnitsToMillivolts(batteryUnits);
+  batteryCentiPercent = batteryCentiPercentFromUnits(batteryUnits);
+  char voltageText[12];
+  formatBatteryVolts(batteryUnits, voltageText, sizeof(voltageText));
   
   String json = "{\"status\":\"ok\",";
   json += "\"currentAngle\":"+String(currentAngle)+",";
   json += "\"speed\":"+String(speedSetting)+",";
+  int speedDps = sliderToDegreesPerSecond(speedTenths);
+  unsigned long feedMs = estimateFeedMs(feedRepeats, maxAngle - minAngle, speedDps);
+  json += "\"speedDps\":"+String(speedDps)+",";
+  json += "\"speedCalibrated\":"+String(speedCalibration.valid ? "true" : "false")+",";
+  json += "\"feedDurationMs\":"+String(feedMs)+",";
+  json += "\"feedEnergyMah\":"+String(estimateFeedEnergyMah(feedMs),3)+",";
+  json += "\"doseCalibrated\":"+String(dosingCalibrated() ? "true" : "false")+",";
+  json += "\"faultCount\":"+String(faultCount())+",";
+  json += "\"buttonPresses\":"+String(buttonPressCount())+",";
+  json += "\"servoAttached\":"+String(motionIsAttached() ? "true" : "false")+",";
+  json += "\"servoSettleMs\":"+String(servoSettleMs)+",";
+  json += "\"servoEnergySavedMah\":"+String(motionEnergySavedMah(),2)+",";
   json += "\"feedRepeats\":"+String(feedRepeats)+",";
   json += "\"powerSaveMode\":"+String(powerSaveMode ? "true" : "false")+",";
-  json += "\"batteryVoltage\":"+String(batteryVoltage,2)+",";
-  json += "\"batteryPercent\":"+String(batteryPercent,0)+",";
+  json += "\"idleLevel\":\""+String(idleLevelName(idleCurrentLevel()))+"\",";
+  json += "\"idleForS\":"+String(idleForMs() / 1000)+",";
+  json += "\"wifiDuty\":"+wifiDutyToJson()+",";
+  json += "\"catchupPolicy\":\""+String(catchupPolicyName(catchupPolicy))+"\",";
+  json += "\"catchupGraceMin\":"+String(catchupGraceMin)+",";
+  json += "\"wifiProfile\":\""+String(wifiPowerProfileName(wifiPowerProfile))+"\",";
+  json += "\"batteryVoltage\":"+String(voltageText)+",";
+  json += "\"batteryPercent\":"+String(batteryPercentFromUnits(batteryUnits))+",";
+  BatteryForecast forecast = batteryForecastCompute(batteryCentiPercent);
+  json += "\"daysRemaining\":"+String(forecast.daysRemaining,1)+",";
+  json += "\"dailyMah\":"+String(forecast.dailyMah,1)+",";
+  json += "\"measuredDrainMa\":"+String(forecast.measuredDrainMa,1)+",";
+  json += "\"adcCalibration\":\""+String(batteryAdcCalibrationName())+"\",";
 
   NextFeedInfo nextFeed = computeNextFeed();
   json += "\"nextFeedMinutes\":"+String(nextFeed.minutesUntil)+",";
@@ -1615,28 +1899,19 @@ void handleStatus(){
   json += "\"nextFeedMinute\":"+String(nextFeed.targetMinute)+",";
   
   // Додаємо масив годувань
-  json += "\"feedTimes\":[";
-  for(int i = 0; i < feedTimesCount; i++) {
-    if(i > 0) json += ",";
-    json += "{\"h\":"+String(feedTimes[i].hour)+",\"m\":"+String(feedTimes[i].minute)+",\"r\":"+String(feedTimes[i].repeats)+"}";
-  }
-  json += "],";
+  json += "\"feedTimes\":"+scheduleToJson()+",";
   
   // Для сумісності додаємо старі поля
-  json += "\"feedHour1\":"+String(feedHour1)+",";
-  json += "\"feedMinute1\":"+String(feedMinute1)+",";
-  json += "\"feedHour2\":"+String(feedHour2)+",";
-  json += "\"feedMinute2\":"+String(feedMinute2)+",";
-  json += "\"feedRepeats1\":"+String(feedRepeats1)+",";
-  json += "\"feedRepeats2\":"+String(feedRepeats2)+",";
-  time_t now = time(nullptr);
-  struct tm localTime;
+  time_t now = localClockUtc();
   char timeBuf[6] = "--:--";
-  time_t adjusted = now + KIEV_UTC_OFFSET_SECONDS;
-  if (gmtime_r(&adjusted, &localTime) && localTime.tm_year + 1900 >= 2020) {
-    snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d", localTime.tm_hour, localTime.tm_min);
+  if (localClockValid()) {
+    int minuteOfDay = constrain(localMinuteOfDay(), 0, 24 * 60 - 1);
+    snprintf(timeBuf, sizeof(timeBuf), "%02d:%02d", minuteOfDay / 60, minuteOfDay % 60);
   }
   json += "\"currentTime\":\""+String(timeBuf)+"\",";
+  json += "\"timezone\":\""+String(localTimeZone().name)+"\",";
+  json += "\"utcOffsetMin\":"+String(localUtcOffset(now) / 60)+",";
+  json += "\"clock\":"+timeKeeperToJson()+",";
   json += "\"wifiSSID\":\""+savedSSID+"\",";
   json += "\"isAPMode\":"+String(isAPMode ? "true" : "false")+",";
   if(!isAPMode && WiFi.status() == WL_CONNECTED) {
@@ -1655,38 +1930,194 @@ void handleSetAngle(){
   }
   server.send(200,"text/plain","ok"); 
 }
-void handleFeedNow(){ server.send(200,"text/plain","feeding"); delay(10); feedSequence(feedRepeats); }
-void handleSetSpeed(){ if(server.hasArg("speed")){ speedSetting = server.arg("speed").toFloat(); preferences.putFloat("speed",speedSetting);} server.send(200,"text/plain","ok"); }
-void handleSetRepeats(){ if(server.hasArg("repeats")){ feedRepeats = server.arg("repeats").toInt(); preferences.putInt("feedRepeats",feedRepeats);} server.send(200,"text/plain","ok"); }
+void handleFeedNow(){
+  float grams = server.hasArg("grams") ? server.arg("grams").toFloat() : 0.0f;
+  server.send(200,"text/plain","feeding");
+  delay(10);
+  feedDose(EVENT_SOURCE_WEB, feedRepeats, grams);
+}
+// Прогін туди-назад на п'яти швидкостях; кінець ходу - за спадом струму шини серво
+void handleCalibrateSpeed(){
+  if (!currentSenseAvailable()) {
+    server.send(409,"text/plain","current sense required");
+    return;
+  }
+  if (manualMoving || abs(maxAngle - minAngle) < 10) {
+    server.send(409,"text/plain","busy");
+    return;
+  }
+  server.send(200,"text/plain","calibrating");
+  delay(10);
+  manualMoving = true;
+  PowerState previousState = powerStateEnter(POWER_SERVO);
+  runSpeedCalibration(minAngle, maxAngle, preferences);
+  powerStateRestore(previousState);
+  currentAngle = static_cast<int>(motionCurrentAngle() + 0.5f);
+  manualMoving = false;
+  updateForecastSchedule();
+  updateActivity();
+}
+void handleSetSpeed(){ if(server.hasArg("speed")){ speedSetting = constrain(server.arg("speed").toFloat(), SPEED_SLIDER_MIN, SPEED_SLIDER_MAX); speedTenths = speedToTenths(speedSetting); appConfig.speed = speedSetting; appConfigSave(preferences); updateForecastSchedule();} server.send(200,"text/plain","ok"); }
+// === Dosing handlers ===
+void handleDose(){
+  String json = "{\"calibrated\":"+String(dosingCalibrated() ? "true" : "false")+",";
+  json += "\"maxTravel\":"+String(abs(maxAngle - minAngle))+",";
+  json += "\"points\":"+dosingToJson();
+  if (server.hasArg("grams")) {
+    DosePlan plan = planDose(server.arg("grams").toFloat(), abs(maxAngle - minAngle));
+    if (plan.capped) {
+      server.send(400,"text/plain","grams above max dose "+String(dosingMaxGrams(abs(maxAngle - minAngle)),1));
+      return;
+    }
+    json += ",\"plan\":{\"sweeps\":"+String(plan.sweeps)+",\"travel\":"+String(plan.travelDeg,1)+
+            ",\"expectedGrams\":"+String(plan.expectedGrams,2)+"}";
+  }
+  json += "}";
+  server.send(200,"application/json", json);
+}
+
+// Пробний прогін для зважування: /api/dose/test?travel=90&sweeps=10
+void handleDoseTest(){
+  if (manualMoving || !server.hasArg("travel")) {
+    server.send(400,"text/plain","busy or missing travel");
+    return;
+  }
+  // Хід у межах minAngle..maxAngle; нечислове чи непозитивне значення - помилка
+  float travel = server.arg("travel").toFloat();
+  float fullTravel = abs(maxAngle - minAngle);
+  if (!(travel > 0.0f) || fullTravel < 1.0f) {
+    server.send(400,"text/plain","invalid travel");
+    return;
+  }
+  travel = constrain(travel, 0.0f, fullTravel);
+  int sweeps = server.hasArg("sweeps") ? constrain((int)server.arg("sweeps").toInt(), 1, 50) : 10;
+  server.send(200,"text/plain","dispensing");
+  delay(10);
+  feedSequence(EVENT_SOURCE_DOSE_TEST, sweeps, travel);
+  updateActivity();
+}
+
+// Запис зважених грамів: /api/dose/calibrate?travel=90&sweeps=10&grams=4.2 або ?clear=1
+void handleDoseCalibrate(){
+  if (server.hasArg("clear")) {
+    dosingClear(preferences);
+    updateForecastSchedule();
+    server.send(200,"text/plain","ok");
+    return;
+  }
+  if (!server.hasArg("travel") || !server.hasArg("sweeps") || !server.hasArg("grams")) {
+    server.send(400,"text/plain","Missing travel, sweeps or grams");
+    return;
+  }
+  bool ok = dosingAddPoint(server.arg("travel").toFloat(), server.arg("sweeps").toInt(),
+                           server.arg("grams").toFloat(), preferences);
+  updateForecastSchedule();
+  server.send(ok ? 200 : 400, "text/plain", ok ? "ok" : "invalid point");
+}
+
+void handleBatteryHistory(){
+  static uint8_t buffer[BATTERY_HISTORY_CAPACITY * 12 + 4];
+  int points = server.hasArg("points") ? server.arg("points").toInt() : 120;
+  points = constrain(points, 3, BATTERY_HISTORY_CAPACITY);
+  size_t len = batteryHistoryEncode(points, buffer, sizeof(buffer));
+  server.sendHeader("Cache-Control", "no-store");
+  server.send_P(200, "application/octet-stream", reinterpret_cast<const char*>(buffer), len);
+}
+
+void handleSetBatteryCapacity(){
+  if(server.hasArg("mah")){
+    batteryForecastSetCapacity(server.arg("mah").toFloat(), preferences);
+  }
+  server.send(200,"text/plain","ok");
+}
+
+void handleSetHistoryInterval(){
+  if(server.hasArg("s")){
+    batteryHistorySetInterval(server.arg("s").toInt(), preferences);
+  }
+  server.send(200,"text/plain","ok");
+}
+
+// Журнал подій сторінками від новіших: /api/log?limit=50&before=<next з попередньої сторінки>
+void handleEventLog(){
+  if(!eventLogAvailable()){
+    server.send(503,"text/plain","event log partition missing");
+    return;
+  }
+  uint32_t before = server.hasArg("before") ? static_cast<uint32_t>(strtoul(server.arg("before").c_str(), nullptr, 10)) : 0;
+  int limit = server.hasArg("limit") ? constrain((int)server.arg("limit").toInt(), 1, 100) : 50;
+  server.send(200,"application/json", eventLogToJson(before, limit));
+}
+
+// Фази завантаження і готовність підсистем у мкс від старту: /api/boot
+void handleBoot(){
+  server.send(200,"application/json", bootProfileToJson());
+}
+
+// Затримки і тривалість годувань: /api/feedTiming, ?reset=1 - почати вибірку заново
+void handleFeedTiming(){
+  if(server.hasArg("reset")) feedTimingReset();
+  server.send(200,"application/json", feedTimingToJson());
+}
+
+void handleFaults(){
+  String json = "{\"currentSense\":"+String(currentSenseAvailable() ? "true" : "false")+",";
+  json += "\"stallMa\":"+String(stallDetector.config.thresholdMa,0)+",";
+  json += "\"stallHoldMs\":"+String(stallDetector.config.holdUs / 1000)+",";
+  json += "\"faults\":"+faultsToJson()+"}";
+  server.send(200,"application/json", json);
+}
+
+void handlePower(){
+  if(server.hasArg("reset") && server.arg("reset") == "1") powerProfileReset();
+  server.send(200,"application/json", powerProfileToJson());
+}
+
+void handleSetPowerCurrent(){
+  PowerState state;
+  if(!server.hasArg("state") || !server.hasArg("ma") || !powerStateFromName(server.arg("state"), state)){
+    server.send(400,"text/plain","state and ma required");
+    return;
+  }
+  if(!powerSetStateCurrent(state, server.arg("ma").toFloat(), preferences)){
+    server.send(400,"text/plain","ma out of range");
+    return;
+  }
+  server.send(200,"text/plain","ok");
+}
+
+void handleSetStall(){
+  float ma = server.hasArg("ma") ? server.arg("ma").toFloat() : stallDetector.config.thresholdMa;
+  unsigned long ms = server.hasArg("ms") ? server.arg("ms").toInt() : stallDetector.config.holdUs / 1000;
+  setStallThreshold(ma, ms, preferences);
+  server.send(200,"text/plain","ok");
+}
+
+// /api/setServoSettle?ms=500; 0 - тримати позицію постійно, але лише поки плата не спить
+void handleSetServoSettle(){
+  if(server.hasArg("ms")){
+    long ms = server.arg("ms").toInt();
+    servoSettleMs = constrain(ms, 0L, 600000L);
+    appConfig.servoSettleMs = servoSettleMs;
+    appConfigSave(preferences);
+  }
+  server.send(200,"text/plain","ok");
+}
+void handleSetRepeats(){ if(server.hasArg("repeats")){ feedRepeats = server.arg("repeats").toInt(); appConfig.feedRepeats = feedRepeats; appConfigSave(preferences);} server.send(200,"text/plain","ok"); }
 void handleSetFeedTimes(){
   if(server.hasArg("data")) {
     // Новий формат - JSON масив
     String jsonData = server.arg("data");
     jsonData.trim();
 
-    // Вичищаємо попередні значення у сховищі
-    char removeKey[20];
-    for(int i = 0; i < MAX_FEED_TIMES; i++) {
-      sprintf(removeKey, "feedH%d", i);
-      preferences.remove(removeKey);
-      sprintf(removeKey, "feedM%d", i);
-      preferences.remove(removeKey);
-      sprintf(removeKey, "feedR%d", i);
-      preferences.remove(removeKey);
-    }
-
-    feedTimesCount = 0;
-    for(int i = 0; i < MAX_FEED_TIMES; i++) {
-      feedTimes[i].hour = 0;
-      feedTimes[i].minute = 0;
-      feedTimes[i].repeats = 1;
-      feedTimes[i].done = false;
-    }
-
+    // Спершу розбираємо і перевіряємо всі слоти: відхилений запит не чіпає розклад
+    FeedTime slots[MAX_FEED_TIMES];
+    int slotCount = 0;
+    const float travel = abs(maxAngle - minAngle);
     int depth = 0;
     int objStart = -1;
     const int len = jsonData.length();
-    for(int idx = 0; idx < len && feedTimesCount < MAX_FEED_TIMES; idx++) {
+    for(int idx = 0; idx < len && slotCount < MAX_FEED_TIMES; idx++) {
       char c = jsonData.charAt(idx);
       if(c == '{') {
         if(depth == 0) {
@@ -1697,100 +2128,139 @@ void handleSetFeedTimes(){
         depth--;
         if(depth == 0 && objStart != -1) {
           String obj = jsonData.substring(objStart + 1, idx);
-          int h = extractIntField(obj, 'h', 10);
-          int m = extractIntField(obj, 'm', 0);
-          int r = extractIntField(obj, 'r', 1);
-
-          h = constrain(h, 0, 23);
-          m = constrain(m, 0, 59);
-          r = max(1, r);
-
-          feedTimes[feedTimesCount].hour = h;
-          feedTimes[feedTimesCount].minute = m;
-          feedTimes[feedTimesCount].repeats = r;
-          feedTimes[feedTimesCount].done = false;
-          feedTimesCount++;
+          const float grams = extractFloatField(obj, 'g', 0.0f);
+          if(grams > 0.0f && planDose(grams, travel).capped) {
+            server.send(400,"text/plain","g above max dose "+String(dosingMaxGrams(travel),1));
+            return;
+          }
+          FeedTime slot = makeFeedTime(extractIntField(obj, 'h', 10), extractIntField(obj, 'm', 0),
+                                       extractIntField(obj, 'r', 1), grams);
+          // w - маска днів (біт 0 - неділя), n - раз на N діб, s/e - перший і останній день
+          slot.weekdays = constrain(extractIntField(obj, 'w', SCHEDULE_ALL_DAYS), 0, SCHEDULE_ALL_DAYS);
+          slot.everyDays = constrain(extractIntField(obj, 'n', 1), 1, SCHEDULE_MAX_EVERY_DAYS);
+          slot.startDay = constrain(extractIntField(obj, 's', SCHEDULE_OPEN_START), 0, SCHEDULE_OPEN_END);
+          slot.endDay = constrain(extractIntField(obj, 'e', SCHEDULE_OPEN_END), 0, SCHEDULE_OPEN_END);
+          // Інтервал без дати початку рахуємо від сьогодні
+          if(slot.everyDays > 1 && slot.startDay == SCHEDULE_OPEN_START && localClockValid()) {
+            slot.startDay = localDayNumber();
+          }
+          slots[slotCount++] = slot;
           objStart = -1;
         }
       }
     }
 
+    scheduleClear();
+    for(int i = 0; i < slotCount; i++) scheduleAdd(slots[i]);
     if(feedTimesCount == 0) {
-      feedTimes[feedTimesCount++] = {10, 0, 1, false};
-    }
-
-    preferences.putInt("feedTimesCount", feedTimesCount);
-    char key[20];
-    for(int i = 0; i < feedTimesCount; i++) {
-      sprintf(key, "feedH%d", i);
-      preferences.putInt(key, feedTimes[i].hour);
-      sprintf(key, "feedM%d", i);
-      preferences.putInt(key, feedTimes[i].minute);
-      sprintf(key, "feedR%d", i);
-      preferences.putInt(key, feedTimes[i].repeats);
-    }
-
-    if(feedTimesCount > 0) {
-      feedHour1 = feedTimes[0].hour;
-      feedMinute1 = feedTimes[0].minute;
-      feedRepeats1 = feedTimes[0].repeats;
-    } else {
-      feedHour1 = 10;
-      feedMinute1 = 0;
-      feedRepeats1 = 1;
-    }
-    if(feedTimesCount > 1) {
-      feedHour2 = feedTimes[1].hour;
-      feedMinute2 = feedTimes[1].minute;
-      feedRepeats2 = feedTimes[1].repeats;
-    } else {
-      feedHour2 = 0;
-      feedMinute2 = 0;
-      feedRepeats2 = 1;
+      scheduleAdd(makeFeedTime(10, 0, 1, 0.0f));
     }
+    scheduleSave(preferences);
   } else {
-    // Старий формат для сумісності
-    feedHour1 = server.arg("h1").toInt(); feedMinute1 = server.arg("m1").toInt();
-    feedHour2 = server.arg("h2").toInt(); feedMinute2 = server.arg("m2").toInt();
-    feedRepeats1 = server.arg("r1").toInt(); feedRepeats2 = server.arg("r2").toInt();
-    
-    feedTimesCount = 2;
-    feedTimes[0] = {feedHour1, feedMinute1, feedRepeats1, false};
-    feedTimes[1] = {feedHour2, feedMinute2, feedRepeats2, false};
-    
-    preferences.putInt("feedTimesCount", 2);
-    char key[20];
-    sprintf(key, "feedH%d", 0);
-    preferences.putInt(key, feedHour1);
-    sprintf(key, "feedM%d", 0);
-    preferences.putInt(key, feedMinute1);
-    sprintf(key, "feedR%d", 0);
-    preferences.putInt(key, feedRepeats1);
-    sprintf(key, "feedH%d", 1);
-    preferences.putInt(key, feedHour2);
-    sprintf(key, "feedM%d", 1);
-    preferences.putInt(key, feedMinute2);
-    sprintf(key, "feedR%d", 1);
-    preferences.putInt(key, feedRepeats2);
+    // Старий формат запиту h1/m1/r1, h2/m2/r2 - одразу у два слоти
+    scheduleClear();
+    scheduleAdd(makeFeedTime(server.arg("h1").toInt(), server.arg("m1").toInt(), server.arg("r1").toInt(), 0.0f));
+    scheduleAdd(makeFeedTime(server.arg("h2").toInt(), server.arg("m2").toInt(), server.arg("r2").toInt(), 0.0f));
+    scheduleSave(preferences);
   }
   
-  preferences.putInt("feedHour1",feedHour1);
-  preferences.putInt("feedMinute1",feedMinute1);
-  preferences.putInt("feedHour2",feedHour2);
-  preferences.putInt("feedMinute2",feedMinute2);
-  preferences.putInt("feedRepeats1",feedRepeats1);
-  preferences.putInt("feedRepeats2",feedRepeats2);
+  catchupForgetSlots();
+  updateForecastSchedule();
+  updateActivity();
+  server.send(200,"text/plain","ok");
+}
+
+// Пороги сну в секундах: /api/setIdle?modemS=30&lightS=300&deepS=1800&deepLeadS=1200 (deepS=0 вимикає deep sleep)
+void handleSetIdle(){
+  IdleGovernorConfig config = idleConfig;
+  if(server.hasArg("modemS")) config.modemAfterS = constrain((long)server.arg("modemS").toInt(), 5L, 3600L);
+  if(server.hasArg("lightS")) config.lightAfterS = constrain((long)server.arg("lightS").toInt(), 10L, 86400L);
+  if(server.hasArg("deepS")) config.deepAfterS = constrain((long)server.arg("deepS").toInt(), 0L, 86400L);
+  if(server.hasArg("deepLeadS")) config.deepMinLeadS = constrain((long)server.arg("deepLeadS").toInt(), 300L, 86400L);
+  idleSetConfig(config, preferences);
+  updateActivity();
+  server.send(200,"text/plain","ok");
+}
+
+// Часовий пояс: /api/setTimezone?name=Europe/Kyiv; без параметра - список доступних
+void handleSetTimezone(){
+  if(!server.hasArg("name")){
+    server.send(200,"application/json", localTimeZonesJson());
+    return;
+  }
+  if(!localTimeSetZone(server.arg("name"), preferences)){
+    server.send(400,"text/plain","unknown timezone");
+    return;
+  }
   updateActivity();
   server.send(200,"text/plain","ok");
 }
 
+// Час із браузера, коли NTP недоступний: /api/setTime?epoch=1718000000&ms=250
+void handleSetTime(){
+  if(!server.hasArg("epoch")){
+    server.send(200,"application/json", timeKeeperToJson());
+    return;
+  }
+  uint32_t epoch = static_cast<uint32_t>(strtoul(server.arg("epoch").c_str(), nullptr, 10));
+  uint16_t ms = server.hasArg("ms") ? constrain(server.arg("ms").toInt(), 0L, 999L) : 0;
+  if(!timeKeeperSetFromBrowser(epoch, ms)){
+    server.send(200,"text/plain","ignored");
+    return;
+  }
+  updateActivity();
+  server.send(200,"text/plain","ok");
+}
+
+// Пропущені годування: /api/setCatchup?policy=skip|once|all&graceMin=120
+void handleSetCatchup(){
+  CatchupPolicy policy = catchupPolicy;
+  if(server.hasArg("policy") && !catchupPolicyFromName(server.arg("policy"), policy)){
+    server.send(400,"text/plain","unknown policy");
+    return;
+  }
+  long graceMin = server.hasArg("graceMin") ? server.arg("graceMin").toInt() : catchupGraceMin;
+  catchupSetPolicy(policy, constrain(graceMin, 1L, 720L), preferences);
+  server.send(200,"text/plain","ok");
+}
+
+void handleWifiPower(){
+  server.send(200,"application/json", wifiPowerToJson());
+}
+
+// /api/setWifiPower?profile=maxPerformance|balanced|minModem
+void handleSetWifiPower(){
+  WifiPowerProfile profile;
+  if(!server.hasArg("profile") || !wifiPowerProfileFromName(server.arg("profile"), profile)){
+    server.send(400,"text/plain","unknown profile");
+    return;
+  }
+  server.send(200,"text/plain","ok");
+  delay(10);
+  wifiPowerSetProfile(profile, preferences);
+  updateActivity();
+}
+
+// Вікна зв'язку: /api/setWifiDuty?enabled=1&leadS=120&afterS=300&checkInMin=60&checkInS=120
+void handleSetWifiDuty(){
+  WifiDutyConfig config = wifiDutyConfig;
+  if(server.hasArg("enabled")) config.enabled = server.arg("enabled") == "1" || server.arg("enabled") == "true";
+  if(server.hasArg("leadS")) config.feedLeadS = constrain((long)server.arg("leadS").toInt(), 30L, 3600L);
+  if(server.hasArg("afterS")) config.feedAfterS = constrain((long)server.arg("afterS").toInt(), 30L, 3600L);
+  if(server.hasArg("checkInMin")) config.checkInMin = constrain((long)server.arg("checkInMin").toInt(), 0L, 1440L);
+  if(server.hasArg("checkInS")) config.checkInS = constrain((long)server.arg("checkInS").toInt(), 30L, 3600L);
+  wifiDutySetConfig(config, preferences);
+  updateForecastSchedule();
+  updateActivity();
+  server.send(200,"application/json", wifiDutyToJson());
+}
+
 void handleSetPowerMode(){
   if(server.hasArg("enabled")){
     powerSaveMode = server.arg("enabled") == "true";
-    preferences.putBool("powerSaveMode", powerSaveMode);
-    if (!powerSaveMode) {
-      autoFeedSleepPending = false;
-    }
+    appConfig.powerSaveMode = powerSaveMode;
+    appConfigSave(preferences);
+    updateForecastSchedule();
     updateActivity();
   }
   server.send(200,"text/plain","ok");
@@ -1799,164 +2269,150 @@ void handleSetPowerMode(){
 
 // === Setup ===
 void setup(){
+  bootProfileBegin();
   Serial.begin(115200);
-  configureBatteryAdc();
-  pinMode(BUTTON_PIN, INPUT_PULLUP);
-  pinMode(BATTERY_PIN, INPUT);
-
-  mg996r.setPeriodHertz(50);
-  mg996r.attach(SERVO_PIN,600,2400);
-  mg996r.write(currentAngle);
 
+  bootPhaseBegin(BOOT_PHASE_NVS);
   preferences.begin("feeder", false);
-  speedSetting = preferences.getFloat("speed",20.0);
-  feedRepeats = preferences.getInt("feedRepeats",1);
-  powerSaveMode = preferences.getBool("powerSaveMode", true);
-  autoFeedSleepPending = false;
-  lastAutoFeedMillis = 0;
+  // Усі скалярні налаштування - одним читанням; модулі далі беруть їх з appConfig
+  appConfigLoad(preferences);
+  // Облік станів живлення - до Wi-Fi: асоціація при старті теж іде в wifiConnect
+  powerProfileBegin();
+  bootPhaseEnd(BOOT_PHASE_NVS);
+
+  // Wi-Fi першим: асоціація і DHCP ідуть у власній задачі паралельно з рештою
+  // setup(), mDNS і SNTP стартують з loop() за подією отримання IP
+  bootPhaseBegin(BOOT_PHASE_WIFI_START);
+  wifiPowerBegin();
+  wifiLoadCredentials(preferences);
+  wifiDutyBegin();
+  bootPhaseEnd(BOOT_PHASE_WIFI_START);
+
+  bootPhaseBegin(BOOT_PHASE_ADC);
+  configureBatteryAdc(BATTERY_PIN);
+  buttonBegin(BUTTON_PIN);
+  pinMode(BATTERY_PIN, INPUT);
+  bootPhaseEnd(BOOT_PHASE_ADC);
+
+  bootPhaseBegin(BOOT_PHASE_SERVO);
+  motionBegin(mg996r, SERVO_PIN, SERVO_POWER_PIN, currentAngle);
+  bootPhaseEnd(BOOT_PHASE_SERVO);
+  bootReady(BOOT_READY_SERVO);
+
+  bootPhaseBegin(BOOT_PHASE_CONFIG);
+  speedSetting = appConfig.speed;
+  speedTenths = speedToTenths(speedSetting);
+  speedModelLoad(preferences);
+  dosingLoad(preferences);
+  catchupBegin(preferences);
+  timeKeeperBegin(preferences);
+  localTimeBegin();
+  eventLogBegin();
+  eventLogAppend(EVENT_BOOT, esp_reset_reason(), esp_sleep_get_wakeup_cause(),
+                 static_cast<uint16_t>(min(readBatteryMillivolts(), static_cast<uint32_t>(65535))));
+  currentSenseBegin(CURRENT_SENSE_PIN);
+  batteryForecastBegin(preferences);
+  batteryHistoryBegin();
+  if (currentSenseAvailable()) {
+    motionSetSampleHook(currentSenseMotionSample, STALL_SAMPLE_INTERVAL_US);
+  }
+  servoSettleMs = appConfig.servoSettleMs;
+  feedRepeats = appConfig.feedRepeats;
+  powerSaveMode = appConfig.powerSaveMode;
   
   // Завантажуємо масив годувань
-  feedTimesCount = preferences.getInt("feedTimesCount", 0);
-  if(feedTimesCount <= 0 || feedTimesCount > MAX_FEED_TIMES) {
-    feedTimesCount = 0;
-
-    int storedH1 = preferences.getInt("feedHour1", -1);
-    int storedM1 = preferences.getInt("feedMinute1", -1);
-    int storedR1 = preferences.getInt("feedRepeats1", -1);
-
-    if(storedH1 < 0) storedH1 = 10;
-    if(storedM1 < 0) storedM1 = 0;
-    if(storedR1 < 0) storedR1 = 1;
-
-    feedTimes[feedTimesCount++] = {storedH1, storedM1, storedR1, false};
-
-    if(preferences.isKey("feedHour2") && preferences.isKey("feedMinute2")) {
-      int storedH2 = preferences.getInt("feedHour2", storedH1);
-      int storedM2 = preferences.getInt("feedMinute2", storedM1);
-      int storedR2 = preferences.getInt("feedRepeats2", storedR1);
-      feedTimes[feedTimesCount++] = {storedH2, storedM2, storedR2, false};
-    }
-  } else {
-    // Завантажуємо збережені годування
-    char key[20];
-    for(int i = 0; i < feedTimesCount; i++) {
-      sprintf(key, "feedH%d", i);
-      feedTimes[i].hour = preferences.getInt(key, 10);
-      sprintf(key, "feedM%d", i);
-      feedTimes[i].minute = preferences.getInt(key, 0);
-      sprintf(key, "feedR%d", i);
-      feedTimes[i].repeats = preferences.getInt(key, 1);
-      feedTimes[i].done = false;
-    }
-  }
-
-  // Синхронізуємо значення для сумісності зі старим кодом
-  if(feedTimesCount > 0) {
-    feedHour1 = feedTimes[0].hour;
-    feedMinute1 = feedTimes[0].minute;
-    feedRepeats1 = feedTimes[0].repeats;
-  }
-  if(feedTimesCount > 1) {
-    feedHour2 = feedTimes[1].hour;
-    feedMinute2 = feedTimes[1].minute;
-    feedRepeats2 = feedTimes[1].repeats;
-  } else {
-    feedHour2 = 0;
-    feedMinute2 = 0;
-    feedRepeats2 = 1;
-  }
+  scheduleLoad(preferences);
   
   // Ініціалізуємо час останньої активності
-  lastActivity = millis();
+  idleGovernorBegin();
+  bootPhaseEnd(BOOT_PHASE_CONFIG);
+  bootReady(BOOT_READY_CONFIG);
+
+  // Розбудили кнопкою з deep sleep: годуємо одразу, не чекаючи Wi-Fi
+  if (buttonWokeFromDeepSleep()) {
+    Serial.println("Woken by button: feeding");
+    feedSequence(EVENT_SOURCE_BUTTON);
+  }
 
-  // Ініціалізуємо WiFi
-  initWiFi(preferences);
+  updateForecastSchedule();
 
+  bootPhaseBegin(BOOT_PHASE_ROUTES);
   server.on("/", handleRoot);
   server.on("/info", handleInfo);
   server.on("/api/status", handleStatus);
   server.on("/api/setAngle", handleSetAngle);
   server.on("/api/feedNow", handleFeedNow);
   server.on("/api/setSpeed", handleSetSpeed);
+  server.on("/api/calibrateSpeed", handleCalibrateSpeed);
+  server.on("/api/setServoSettle", handleSetServoSettle);
+  server.on("/api/history/battery", handleBatteryHistory);
+  server.on("/api/setHistoryInterval", handleSetHistoryInterval);
+  server.on("/api/setBatteryCapacity", handleSetBatteryCapacity);
+  server.on("/api/faults", handleFaults);
+  server.on("/api/log", handleEventLog);
+  server.on("/api/feedTiming", handleFeedTiming);
+  server.on("/api/setStall", handleSetStall);
+  server.on("/api/power", handlePower);
+  server.on("/api/setPowerCurrent", handleSetPowerCurrent);
+  server.on("/api/dose", handleDose);
+  server.on("/api/dose/test", handleDoseTest);
+  server.on("/api/dose/calibrate", handleDoseCalibrate);
   server.on("/api/setRepeats", handleSetRepeats);
   server.on("/api/setFeedTimes", handleSetFeedTimes);
   server.on("/api/setPowerMode", handleSetPowerMode);
+  server.on("/api/setIdle", handleSetIdle);
+  server.on("/api/setWifiDuty", handleSetWifiDuty);
+  server.on("/api/wifiPower", handleWifiPower);
+  server.on("/api/setCatchup", handleSetCatchup);
+  server.on("/api/setTimezone", handleSetTimezone);
+  server.on("/api/setTime", handleSetTime);
+  server.on("/api/setWifiPower", handleSetWifiPower);
+  server.on("/api/boot", handleBoot);
   
   // Налаштування WiFi обробників
   setupWiFiHandlers(server, preferences);
+  bootPhaseEnd(BOOT_PHASE_ROUTES);
   
+  // Сервер слухає і до отримання IP: приймати з'єднання почне, щойно мережа з'явиться
+  bootPhaseBegin(BOOT_PHASE_SERVER);
   server.begin();
+  bootPhaseEnd(BOOT_PHASE_SERVER);
+  bootReady(BOOT_READY_HTTP);
   Serial.println("HTTP server started");
 }
 
 // === Loop ===
 void loop(){
+  PowerState previousState = powerStateEnter(POWER_HTTP);
   server.handleClient();
-  bool buttonState=digitalRead(BUTTON_PIN);
-  if(lastButtonState==HIGH && buttonState==LOW && !manualMoving){ feedSequence(); }
-  lastButtonState = buttonState;
+  powerStateRestore(previousState);
+  // Клієнт тримається після відповіді (keep-alive), тож відкрита сторінка не дає заснути
+  if (server.client().connected()) idleNoteActivity();
+  wifiDutyService();
+  timeKeeperTick();
+  localClockTick();
+  motionTick();
+  batteryHistoryTick();
+  // Без радіо журнал пишемо у флеш разом з іншою відкладеною роботою вікна;
+  // наполовину повна черга - одразу, щоб не губити записи
+  if (wifiDutyRadioActive() || eventLogPending() >= EVENT_QUEUE_SIZE / 2) eventLogTick();
+  else if (eventLogPending() > 0) wifiDutyQueue(eventLogFlush);
+  MotionJob job;
+  while (motionTakeJob(job)) runMotionJob(job);
+
+  static unsigned long lastGovernorMillis = 0;
+  if (millis() - lastGovernorMillis >= 1000UL) {
+    lastGovernorMillis = millis();
+    runIdleGovernor();
+  }
 
   // --- Automatic feeding by schedule ---
-  time_t now = time(nullptr);
-  struct tm localTime;
-  time_t adjusted = now + KIEV_UTC_OFFSET_SECONDS;
-  if (!gmtime_r(&adjusted, &localTime) || localTime.tm_year + 1900 < 2020) {
+  if (!localClockValid()) {
     return;
   }
-  if (localTime.tm_year + 1900 >= 2020) {
-    int curHour = localTime.tm_hour;
-    int curMinute = localTime.tm_min;
-
-    // Перевіряємо всі годування з масиву
-    for(int i = 0; i < feedTimesCount; i++) {
-      if (curHour == feedTimes[i].hour && curMinute == feedTimes[i].minute && !feedTimes[i].done) {
-        Serial.printf("Auto feeding (slot %d) %02d:%02d, repeats: %d\n", i+1, curHour, curMinute, feedTimes[i].repeats);
-        performAutoFeeding(feedTimes[i].repeats);
-        feedTimes[i].done = true;
-      }
-
-      // Скидаємо прапорець, коли хвилина змінилася
-      if (curMinute != feedTimes[i].minute) {
-        feedTimes[i].done = false;
-      }
-    }
-
-    // Для сумісності зі старим кодом (коли працює тільки 2 фіксованих годування)
-    if (feedTimesCount == 0) {
-      if (curHour == feedHour1 && curMinute == feedMinute1 && !feed1Done) {
-        Serial.printf("Auto feeding (slot 1 legacy) %02d:%02d, repeats: %d\n", curHour, curMinute, feedRepeats1);
-        performAutoFeeding(feedRepeats1);
-        feed1Done = true;
-      }
-      if (curHour == feedHour2 && curMinute == feedMinute2 && !feed2Done) {
-        Serial.printf("Auto feeding (slot 2 legacy) %02d:%02d, repeats: %d\n", curHour, curMinute, feedRepeats2);
-        performAutoFeeding(feedRepeats2);
-        feed2Done = true;
-      }
-      if (curMinute != feedMinute1) feed1Done = false;
-      if (curMinute != feedMinute2) feed2Done = false;
-    }
-  }
+  bootReady(BOOT_READY_SCHEDULE);
+  time_t now = localClockUtc();
 
-  if (powerSaveMode && autoFeedSleepPending && !manualMoving && !isAPMode) {
-    if (millis() - lastAutoFeedMillis >= 60000UL) {
-      NextFeedInfo nextInfo = computeNextFeed();
-      if (nextInfo.minutesUntil > 0) {
-        long secondsUntil = static_cast<long>(nextInfo.minutesUntil) * 60L;
-        if (secondsUntil > 60) {
-          Serial.printf("Power save: entering light sleep for up to %ld seconds (next feed in %ld seconds)\n",
-                        secondsUntil - 30, secondsUntil);
-          autoFeedSleepPending = false;
-          uint64_t wakeMicros = (secondsUntil - 30) * 1000000ULL;
-          if (wakeMicros < 30000000ULL) wakeMicros = 30000000ULL;
-          esp_sleep_enable_timer_wakeup(wakeMicros);
-          enterLightSleep();
-        } else {
-          autoFeedSleepPending = false;
-        }
-      } else {
-        autoFeedSleepPending = false;
-      }
-    }
-  }
-}
\ No newline at end of file
+  // Перевіряємо всі годування з масиву, включно з пропущеними
+  runSchedulePass(now);
+}
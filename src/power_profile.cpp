@@ -0,0 +1,109 @@
+#include "power_profile.h"
+#include "app_config.h"
+#include <esp_timer.h>
+
+static const char* const STATE_NAMES[POWER_STATE_COUNT] = {
+  "idle", "wifiConnect", "http", "servo", "lightSleep", "idleRadioOff"
+};
+
+static PowerState currentState = POWER_IDLE;
+static int64_t stateSinceUs = 0;
+static int64_t profileStartUs = 0;
+static uint64_t stateUs[POWER_STATE_COUNT] = {};
+
+// esp_timer не зупиняється в light sleep, тож час сну теж потрапляє в облік
+static void closeInterval(int64_t nowUs) {
+  stateUs[currentState] += static_cast<uint64_t>(nowUs - stateSinceUs);
+  stateSinceUs = nowUs;
+}
+
+// Таблиця струмів - в appConfig.powerMa
+void powerProfileBegin() {
+  profileStartUs = esp_timer_get_time();
+  stateSinceUs = profileStartUs;
+}
+
+PowerState powerStateEnter(PowerState state) {
+  PowerState previous = currentState;
+  if (state != currentState) {
+    closeInterval(esp_timer_get_time());
+    currentState = state;
+  }
+  return previous;
+}
+
+void powerStateRestore(PowerState previous) {
+  powerStateEnter(previous);
+}
+
+PowerState powerStateCurrent() {
+  return currentState;
+}
+
+const char* powerStateName(PowerState state) {
+  return state < POWER_STATE_COUNT ? STATE_NAMES[state] : "unknown";
+}
+
+bool powerStateFromName(const String& name, PowerState& state) {
+  for (int i = 0; i < POWER_STATE_COUNT; ++i) {
+    if (name == STATE_NAMES[i]) {
+      state = static_cast<PowerState>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+float powerStateCurrentMa(PowerState state) {
+  return state < POWER_STATE_COUNT ? appConfig.powerMa[state] : 0.0f;
+}
+
+bool powerSetStateCurrent(PowerState state, float ma, Preferences& preferences) {
+  if (state >= POWER_STATE_COUNT || ma < 0.0f || ma > 5000.0f) return false;
+  appConfig.powerMa[state] = static_cast<uint16_t>(ma + 0.5f);
+  appConfigSave(preferences);
+  return true;
+}
+
+// Включно з незакритим інтервалом поточного стану
+uint64_t powerStateMicros(PowerState state) {
+  if (state >= POWER_STATE_COUNT) return 0;
+  uint64_t us = stateUs[state];
+  if (state == currentState) us += static_cast<uint64_t>(esp_timer_get_time() - stateSinceUs);
+  return us;
+}
+
+float powerStateMah(PowerState state) {
+  return powerStateCurrentMa(state) * (powerStateMicros(state) / 3.6e9f);
+}
+
+void powerProfileReset() {
+  int64_t nowUs = esp_timer_get_time();
+  for (int i = 0; i < POWER_STATE_COUNT; ++i) stateUs[i] = 0;
+  profileStartUs = nowUs;
+  stateSinceUs = nowUs;
+}
+
+String powerProfileToJson() {
+  float totalMah = 0.0f;
+  String states = "[";
+  for (int i = 0; i < POWER_STATE_COUNT; ++i) {
+    PowerState state = static_cast<PowerState>(i);
+    float mah = powerStateMah(state);
+    totalMah += mah;
+    if (i > 0) states += ",";
+    states += "{\"state\":\"" + String(STATE_NAMES[i]) + "\",";
+    states += "\"ms\":" + String(static_cast<unsigned long>(powerStateMicros(state) / 1000)) + ",";
+    states += "\"ma\":" + String(appConfig.powerMa[i]) + ",";
+    states += "\"mah\":" + String(mah, 3) + "}";
+  }
+  states += "]";
+
+  unsigned long windowS = static_cast<unsigned long>((esp_timer_get_time() - profileStartUs) / 1000000);
+  String json = "{\"windowS\":" + String(windowS) + ",";
+  json += "\"current\":\"" + String(powerStateName(currentState)) + "\",";
+  json += "\"totalMah\":" + String(totalMah, 3) + ",";
+  json += "\"averageMa\":" + String(windowS > 0 ? totalMah * 3600.0f / windowS : 0.0f, 1) + ",";
+  json += "\"states\":" + states + "}";
+  return json;
+}
@@ -0,0 +1,34 @@
+#ifndef POWER_PROFILE_H
+#define POWER_PROFILE_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// === Power profile ===
+// Облік часу в кожному стані живлення. Разом із таблицею струмів дає
+// розбивку витрат у мА·год: куди саме йде батарея.
+enum PowerState : uint8_t {
+  POWER_IDLE = 0,       // прокинулись, крутимо loop()
+  POWER_WIFI_CONNECT,   // асоціація з точкою доступу
+  POWER_HTTP,           // обробка запиту
+  POWER_SERVO,          // рух сервоприводу
+  POWER_LIGHT_SLEEP,
+  POWER_IDLE_RADIO_OFF, // прокинулись, але Wi-Fi вимкнено поза вікном зв'язку
+  POWER_STATE_COUNT
+};
+
+// === Power Profile Functions ===
+void powerProfileBegin();
+PowerState powerStateEnter(PowerState state);   // повертає попередній стан для powerStateRestore()
+void powerStateRestore(PowerState previous);
+PowerState powerStateCurrent();
+const char* powerStateName(PowerState state);
+bool powerStateFromName(const String& name, PowerState& state);
+float powerStateCurrentMa(PowerState state);
+bool powerSetStateCurrent(PowerState state, float ma, Preferences& preferences);
+uint64_t powerStateMicros(PowerState state);
+float powerStateMah(PowerState state);
+void powerProfileReset();
+String powerProfileToJson();
+
+#endif
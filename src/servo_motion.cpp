@@ -0,0 +1,260 @@
+#include "servo_motion.h"
+#include <esp_timer.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+
+// === Servo pulse range ===
+// Ті самі межі, що й у attach(SERVO_PIN,600,2400): ~1800 мкс на 180°
+const int SERVO_MIN_PULSE_US = 600;
+const int SERVO_MAX_PULSE_US = 2400;
+const int SERVO_MAX_DEG_PER_SEC = 400;          // фізична межа MG996R (~0.15 с / 60°)
+const float MOTION_MAX_ACCEL_DEG_S2 = 3000.0f;  // обмеження прискорення (механічне навантаження)
+const unsigned long MOTION_UPDATE_INTERVAL_US = 20000; // один кадр PWM 50 Гц
+const int SERVO_HOLD_CURRENT_MA = 60;           // струм утримання MG996R з PWM у спокої
+const int SERVO_DETACHED_CURRENT_MA = 6;        // без PWM, але з живленням шини
+const unsigned long SERVO_RAIL_STARTUP_MS = 20; // стабілізація шини після ввімкнення ключа
+
+unsigned long servoSettleMs = 500;
+
+// === Motion state ===
+static Servo* motionServo = nullptr;
+static int motionPin = -1;
+static int motionPowerPin = -1;
+static bool motionAttached = false;
+static bool motionMoving = false;
+static float motionAngle = 0.0f;
+static uint32_t motionSteps = 0;      // кадрів PWM у плавних рухах за весь час
+static int motionPulseUs = SERVO_MIN_PULSE_US;
+static unsigned long lastMotionMs = 0;
+static unsigned long detachedSinceMs = 0;
+static uint64_t detachedTotalMs = 0;
+static uint64_t railOffTotalMs = 0;
+static MotionSampleHook motionSampleHook = nullptr;
+static unsigned long motionSampleIntervalUs = 1000;
+
+static const int MOTION_JOB_QUEUE_LEN = 4;
+static QueueHandle_t motionJobs = nullptr;
+
+int angleToPulseUs(float degrees) {
+  degrees = constrain(degrees, 0.0f, 180.0f);
+  float pulse = SERVO_MIN_PULSE_US + degrees * (SERVO_MAX_PULSE_US - SERVO_MIN_PULSE_US) / 180.0f;
+  return static_cast<int>(pulse + 0.5f);
+}
+
+float pulseUsToAngle(int pulseUs) {
+  pulseUs = constrain(pulseUs, SERVO_MIN_PULSE_US, SERVO_MAX_PULSE_US);
+  return (pulseUs - SERVO_MIN_PULSE_US) * 180.0f / (SERVO_MAX_PULSE_US - SERVO_MIN_PULSE_US);
+}
+
+// === Power gating ===
+void motionEnsureAttached() {
+  if (motionAttached || !motionServo) return;
+  unsigned long detachedFor = millis() - detachedSinceMs;
+  detachedTotalMs += detachedFor;
+  if (motionPowerPin >= 0) {
+    railOffTotalMs += detachedFor;
+    digitalWrite(motionPowerPin, HIGH);
+    delay(SERVO_RAIL_STARTUP_MS);
+  }
+  motionServo->attach(motionPin, SERVO_MIN_PULSE_US, SERVO_MAX_PULSE_US);
+  motionServo->writeMicroseconds(motionPulseUs);
+  motionAttached = true;
+  lastMotionMs = millis();
+}
+
+static void motionDetach() {
+  if (!motionAttached || !motionServo) return;
+  motionServo->detach();
+  if (motionPowerPin >= 0) digitalWrite(motionPowerPin, LOW);
+  motionAttached = false;
+  detachedSinceMs = millis();
+  Serial.println("Servo detached (power gating)");
+}
+
+void motionTick() {
+  if (!motionAttached || servoSettleMs == 0) return;
+  if (millis() - lastMotionMs >= servoSettleMs) {
+    motionDetach();
+  }
+}
+
+bool motionIsAttached() {
+  return motionAttached;
+}
+
+bool motionIsMoving() {
+  return motionMoving;
+}
+
+// Заощаджений заряд порівняно з постійним утриманням позиції
+float motionEnergySavedMah() {
+  uint64_t detachedMs = detachedTotalMs;
+  uint64_t railOffMs = railOffTotalMs;
+  if (!motionAttached) {
+    unsigned long current = millis() - detachedSinceMs;
+    detachedMs += current;
+    if (motionPowerPin >= 0) railOffMs += current;
+  }
+  float savedMaMs = detachedMs * (SERVO_HOLD_CURRENT_MA - SERVO_DETACHED_CURRENT_MA) +
+                    railOffMs * SERVO_DETACHED_CURRENT_MA;
+  return savedMaMs / 3600000.0f;
+}
+
+static void writePulse(float degrees) {
+  motionAngle = constrain(degrees, 0.0f, 180.0f);
+  int pulse = angleToPulseUs(motionAngle);
+  if (pulse == motionPulseUs) return;
+  motionPulseUs = pulse;
+  lastMotionMs = millis();
+  if (motionServo) motionServo->writeMicroseconds(pulse);
+}
+
+void motionBegin(Servo& servo, int pin, int powerPin, int startAngle) {
+  if (!motionJobs) motionJobs = xQueueCreate(MOTION_JOB_QUEUE_LEN, sizeof(MotionJob));
+  motionServo = &servo;
+  motionPin = pin;
+  motionPowerPin = powerPin;
+  if (motionPowerPin >= 0) {
+    pinMode(motionPowerPin, OUTPUT);
+    digitalWrite(motionPowerPin, HIGH);
+  }
+  servo.setPeriodHertz(50);
+  servo.attach(pin, SERVO_MIN_PULSE_US, SERVO_MAX_PULSE_US);
+  motionAttached = true;
+  motionAngle = constrain(startAngle, 0, 180);
+  motionPulseUs = angleToPulseUs(motionAngle);
+  servo.writeMicroseconds(motionPulseUs);
+  lastMotionMs = millis();
+}
+
+// Трапецієвидний профіль швидкості: розгін -> рівномірний рух -> гальмування
+struct MotionProfile {
+  float vmax;
+  float accelTime;
+  float accelDist;
+  float cruiseTime;
+  float totalTime;
+};
+
+static MotionProfile planProfile(float distance, float maxDegPerSec) {
+  MotionProfile p;
+  p.vmax = constrain(maxDegPerSec, 1.0f, static_cast<float>(SERVO_MAX_DEG_PER_SEC));
+  const float accel = MOTION_MAX_ACCEL_DEG_S2;
+  p.accelTime = p.vmax / accel;
+  p.accelDist = 0.5f * accel * p.accelTime * p.accelTime;
+  if (2.0f * p.accelDist > distance) {
+    // Трикутний профіль: не встигаємо розігнатися до vmax
+    p.accelTime = sqrtf(distance / accel);
+    p.accelDist = 0.5f * distance;
+    p.vmax = accel * p.accelTime;
+  }
+  p.cruiseTime = (distance - 2.0f * p.accelDist) / p.vmax;
+  p.totalTime = 2.0f * p.accelTime + p.cruiseTime;
+  return p;
+}
+
+float motionProfileSeconds(float distance, float maxDegPerSec) {
+  distance = fabsf(distance);
+  if (distance < 0.05f) return 0.0f;
+  return planProfile(distance, maxDegPerSec).totalTime;
+}
+
+void motionSetSampleHook(MotionSampleHook hook, unsigned long intervalUs) {
+  motionSampleHook = hook;
+  motionSampleIntervalUs = max(intervalUs, 1000UL);
+}
+
+// Очікування до наступного кадру; з хуком - опитуємо його між кадрами
+static bool waitUntil(unsigned long deadlineUs, unsigned long moveStartUs) {
+  if (!motionSampleHook) {
+    long waitUs = static_cast<long>(deadlineUs - micros());
+    if (waitUs > 0) {
+      delay(waitUs / 1000);
+      delayMicroseconds(waitUs % 1000);
+    }
+    return true;
+  }
+  while (true) {
+    unsigned long nowUs = micros();
+    if (motionSampleHook(moveStartUs, nowUs)) return false;
+    long waitUs = static_cast<long>(deadlineUs - nowUs);
+    if (waitUs <= 0) return true;
+    unsigned long stepUs = min(static_cast<unsigned long>(waitUs), motionSampleIntervalUs);
+    delay(stepUs / 1000);
+    delayMicroseconds(stepUs % 1000);
+  }
+}
+
+// Позиція рахується від часу старту, тому затримки циклу не накопичуються.
+// Повертає false, якщо рух перервав хук (наприклад, заклинювання).
+bool motionMoveTo(float targetDegrees, float maxDegPerSec) {
+  targetDegrees = constrain(targetDegrees, 0.0f, 180.0f);
+  const float start = motionAngle;
+  const float distance = fabsf(targetDegrees - start);
+  if (distance < 0.05f) return true;
+  const float direction = targetDegrees > start ? 1.0f : -1.0f;
+  motionEnsureAttached();
+
+  const MotionProfile p = planProfile(distance, maxDegPerSec);
+  const float accel = MOTION_MAX_ACCEL_DEG_S2;
+  motionMoving = true;
+
+  const unsigned long startUs = micros();
+  unsigned long nextTickUs = startUs;
+  while (true) {
+    float t = (micros() - startUs) / 1000000.0f;
+    if (t >= p.totalTime) break;
+
+    float travelled;
+    if (t < p.accelTime) {
+      travelled = 0.5f * accel * t * t;
+    } else if (t < p.accelTime + p.cruiseTime) {
+      travelled = p.accelDist + p.vmax * (t - p.accelTime);
+    } else {
+      float remaining = p.totalTime - t;
+      travelled = distance - 0.5f * accel * remaining * remaining;
+    }
+    writePulse(start + direction * travelled);
+    motionSteps++;
+
+    nextTickUs += MOTION_UPDATE_INTERVAL_US;
+    if (!waitUntil(nextTickUs, startUs)) {
+      // Зупиняємось там, де є, щоб не тиснути на перешкоду
+      motionMoving = false;
+      return false;
+    }
+  }
+  writePulse(targetDegrees);
+  motionSteps++;
+  motionMoving = false;
+  return true;
+}
+
+void motionJumpTo(float targetDegrees) {
+  motionEnsureAttached();
+  writePulse(targetDegrees);
+}
+
+float motionCurrentAngle() {
+  return motionAngle;
+}
+
+int motionCurrentPulseUs() {
+  return motionPulseUs;
+}
+
+uint32_t motionStepCount() {
+  return motionSteps;
+}
+
+// === Motion jobs ===
+// Безпечно з інших задач (esp_timer); переповнена черга відкидає запит
+bool motionQueueJob(MotionJobKind kind, MotionJobSource source) {
+  if (!motionJobs) return false;
+  MotionJob job = {kind, source, esp_timer_get_time()};
+  return xQueueSend(motionJobs, &job, 0) == pdTRUE;
+}
+
+bool motionTakeJob(MotionJob& job) {
+  return motionJobs && xQueueReceive(motionJobs, &job, 0) == pdTRUE;
+}
@@ -0,0 +1,60 @@
+#ifndef SERVO_MOTION_H
+#define SERVO_MOTION_H
+
+#include <Arduino.h>
+#include <ESP32Servo.h>
+
+// === Servo pulse range ===
+extern const int SERVO_MIN_PULSE_US;
+extern const int SERVO_MAX_PULSE_US;
+extern const int SERVO_MAX_DEG_PER_SEC;
+extern const float MOTION_MAX_ACCEL_DEG_S2;
+extern const unsigned long MOTION_UPDATE_INTERVAL_US;
+extern const int SERVO_HOLD_CURRENT_MA;
+extern const int SERVO_DETACHED_CURRENT_MA;
+
+// Через скільки мс після руху відключати PWM (0 - утримувати постійно)
+extern unsigned long servoSettleMs;
+
+// Викликається під час руху з інтервалом intervalUs; true - перервати рух
+typedef bool (*MotionSampleHook)(unsigned long moveStartUs, unsigned long nowUs);
+
+// === Motion Functions ===
+void motionBegin(Servo& servo, int pin, int powerPin, int startAngle);
+int angleToPulseUs(float degrees);
+float pulseUsToAngle(int pulseUs);
+bool motionMoveTo(float targetDegrees, float maxDegPerSec);
+void motionSetSampleHook(MotionSampleHook hook, unsigned long intervalUs);
+float motionProfileSeconds(float distance, float maxDegPerSec);
+void motionJumpTo(float targetDegrees);
+float motionCurrentAngle();
+int motionCurrentPulseUs();
+uint32_t motionStepCount();
+
+// === Power gating ===
+void motionEnsureAttached();
+void motionTick();
+bool motionIsAttached();
+bool motionIsMoving();
+float motionEnergySavedMah();
+
+// === Motion jobs ===
+// Черга запитів на рух з інших контекстів (таймер кнопки тощо); виконує loop()
+enum MotionJobKind : uint8_t {
+  MOTION_JOB_FEED = 1,
+};
+
+enum MotionJobSource : uint8_t {
+  MOTION_SOURCE_BUTTON = 1,
+};
+
+struct MotionJob {
+  MotionJobKind kind;
+  MotionJobSource source;
+  int64_t queuedUs;     // esp_timer_get_time() у момент постановки
+};
+
+bool motionQueueJob(MotionJobKind kind, MotionJobSource source);
+bool motionTakeJob(MotionJob& job);
+
+#endif
@@ -0,0 +1,166 @@
+#include "speed_model.h"
+#include "servo_motion.h"
+#include "current_sense.h"
+
+// === Speed model ===
+const float SPEED_SLIDER_MIN = 1.0f;
+const float SPEED_SLIDER_MAX = 20.0f;
+const int SPEED_SLIDER_MIN_TENTHS = 10;
+const int SPEED_SLIDER_MAX_TENTHS = 200;
+const int SPEED_MIN_DEG_PER_SEC = 20;
+const int SERVO_MOVING_CURRENT_MA = 900;        // середній струм MG996R під час руху (2S, легке навантаження)
+
+static const unsigned long FEED_PAUSES_MS = 150; // 3 x delay(50) у feedSequence()
+
+static const uint8_t SPEED_CAL_VERSION = 2;       // версія 1 - середня швидкість за часом профілю
+static const uint16_t CALIBRATION_SPEEDS[SPEED_CAL_POINTS] = {20, 60, 120, 240, 400};
+static const unsigned long CAL_SETTLE_TIMEOUT_US = 1500000; // довше - вал не дійшов, а не відстав
+static const int CAL_IDLE_SAMPLES = 32;
+
+SpeedCalibration speedCalibration = {};
+
+void speedModelLoad(Preferences& preferences) {
+  SpeedCalibration stored = {};
+  size_t len = preferences.getBytes("speedCal", &stored, sizeof(stored));
+  if (len == sizeof(stored) && stored.version == SPEED_CAL_VERSION && stored.valid) {
+    speedCalibration = stored;
+  } else {
+    speedCalibration = {};
+    speedCalibration.version = SPEED_CAL_VERSION;
+  }
+}
+
+// Повзунок у десятих (10..200), лінійно на SPEED_MIN..SERVO_MAX °/с, з округленням
+int sliderToDegreesPerSecond(int sliderTenths) {
+  const int minTenths = SPEED_SLIDER_MIN_TENTHS;
+  const int maxTenths = SPEED_SLIDER_MAX_TENTHS;
+  sliderTenths = constrain(sliderTenths, minTenths, maxTenths);
+  const int span = maxTenths - minTenths;
+  return SPEED_MIN_DEG_PER_SEC +
+         ((sliderTenths - minTenths) * (SERVO_MAX_DEG_PER_SEC - SPEED_MIN_DEG_PER_SEC) + span / 2) / span;
+}
+
+int speedToTenths(float sliderSpeed) {
+  return static_cast<int>(sliderSpeed * 10.0f + 0.5f);
+}
+
+// Наскільки хід на опорній точці довший за профіль: серво наздоганяє ШІМ
+static float pointLagMs(int i) {
+  const SpeedCalibrationPoint& p = speedCalibration.points[i];
+  float modelMs = motionProfileSeconds(speedCalibration.travelDeg, p.commandedDps) * 1000.0f;
+  return max(0.0f, p.sweepMs - modelMs);
+}
+
+static float lagMsAt(float commandedDps) {
+  const SpeedCalibrationPoint* p = speedCalibration.points;
+  if (commandedDps <= p[0].commandedDps) return pointLagMs(0);
+  for (int i = 1; i < SPEED_CAL_POINTS; ++i) {
+    if (commandedDps <= p[i].commandedDps) {
+      float t = (commandedDps - p[i - 1].commandedDps) / (p[i].commandedDps - p[i - 1].commandedDps);
+      return pointLagMs(i - 1) + t * (pointLagMs(i) - pointLagMs(i - 1));
+    }
+  }
+  return pointLagMs(SPEED_CAL_POINTS - 1);
+}
+
+// Справжній хід: профіль плюс виміряне запізнення серво
+static float calibratedSweepMs(float travelDeg, float commandedDps) {
+  return motionProfileSeconds(travelDeg, commandedDps) * 1000.0f + lagMsAt(commandedDps);
+}
+
+// Яку швидкість профілю задати, щоб повний хід тривав стільки, скільки модель
+// обіцяє для targetDps. Без калібрування - саму targetDps
+float commandedDegreesPerSecond(float targetDps) {
+  if (!speedCalibration.valid) return targetDps;
+  const float travel = speedCalibration.travelDeg;
+  const float wantMs = motionProfileSeconds(travel, targetDps) * 1000.0f;
+  float lo = targetDps;
+  float hi = SERVO_MAX_DEG_PER_SEC;
+  if (lo >= hi || calibratedSweepMs(travel, hi) >= wantMs) return max(lo, hi);   // швидше серво не встигає
+  // Хід коротшає зі швидкістю профілю: бісекція до ~0.01 °/с
+  for (int i = 0; i < 16; ++i) {
+    float mid = (lo + hi) / 2.0f;
+    if (calibratedSweepMs(travel, mid) > wantMs) lo = mid;
+    else hi = mid;
+  }
+  return hi;
+}
+
+unsigned long estimateSweepMs(float travelDeg, float targetDps) {
+  travelDeg = fabsf(travelDeg);
+  if (travelDeg < 0.05f || targetDps <= 0.0f) return 0;
+  if (!speedCalibration.valid) {
+    return static_cast<unsigned long>(motionProfileSeconds(travelDeg, targetDps) * 1000.0f + 0.5f);
+  }
+  return static_cast<unsigned long>(calibratedSweepMs(travelDeg, commandedDegreesPerSecond(targetDps)) + 0.5f);
+}
+
+unsigned long estimateFeedMs(int repeats, float travelDeg, float targetDps) {
+  if (repeats < 1) repeats = 1;
+  return repeats * (2 * estimateSweepMs(travelDeg, targetDps) + FEED_PAUSES_MS);
+}
+
+float estimateFeedEnergyMah(unsigned long feedMs) {
+  return SERVO_MOVING_CURRENT_MA * feedMs / 3600000.0f;
+}
+
+// Струм утримання позиції: рівень, до якого шина повертається після ходу
+static float measureIdleMa() {
+  float sum = 0.0f;
+  for (int i = 0; i < CAL_IDLE_SAMPLES; ++i) {
+    sum += currentSenseReadMa();
+    delayMicroseconds(STALL_SAMPLE_INTERVAL_US);
+  }
+  return sum / CAL_IDLE_SAMPLES;
+}
+
+// Один хід від старту профілю до спаду струму; 0 - заклинювання або струм не вщух
+static unsigned long timedSweepMs(float target, float commandedDps, float idleMa) {
+  const unsigned long startUs = micros();
+  if (!motionMoveTo(target, commandedDps)) return 0;
+  unsigned long settledUs = 0;
+  if (!currentSenseWaitSettled(idleMa, CAL_SETTLE_TIMEOUT_US, settledUs)) return 0;
+  return (settledUs - startUs + 500) / 1000;
+}
+
+// Калібрувальний прогін: на кожній опорній швидкості хід туди і назад, час -
+// до моменту, коли струм шини повернувся до струму утримання
+bool runSpeedCalibration(int fromAngle, int toAngle, Preferences& preferences) {
+  const int travel = abs(toAngle - fromAngle);
+  if (!currentSenseAvailable() || travel < 10) return false;
+
+  SpeedCalibration result = {};
+  result.version = SPEED_CAL_VERSION;
+  result.travelDeg = travel;
+
+  motionMoveTo(fromAngle, SPEED_MIN_DEG_PER_SEC);
+  delay(300);
+  const float idleMa = measureIdleMa();
+  for (int i = 0; i < SPEED_CAL_POINTS; ++i) {
+    const uint16_t commanded = CALIBRATION_SPEEDS[i];
+    unsigned long forwardMs = timedSweepMs(toAngle, commanded, idleMa);
+    unsigned long backMs = forwardMs > 0 ? timedSweepMs(fromAngle, commanded, idleMa) : 0;
+    if (backMs == 0) {
+      Serial.printf("Speed calibration failed at %u deg/s\n", commanded);
+      motionMoveTo(fromAngle, SPEED_MIN_DEG_PER_SEC);
+      return false;
+    }
+    result.points[i].commandedDps = commanded;
+    result.points[i].sweepMs = static_cast<uint16_t>(min((forwardMs + backMs + 1) / 2, 65535UL));
+    Serial.printf("Speed calibration: %u deg/s -> %u ms per sweep (profile %lu ms)\n", commanded,
+                  result.points[i].sweepMs,
+                  static_cast<unsigned long>(motionProfileSeconds(travel, commanded) * 1000.0f + 0.5f));
+  }
+
+  // Швидший профіль не дає довшого ходу: шум виміру згладжуємо
+  for (int i = 1; i < SPEED_CAL_POINTS; ++i) {
+    if (result.points[i].sweepMs > result.points[i - 1].sweepMs) {
+      result.points[i].sweepMs = result.points[i - 1].sweepMs;
+    }
+  }
+
+  result.valid = 1;
+  speedCalibration = result;
+  preferences.putBytes("speedCal", &speedCalibration, sizeof(speedCalibration));
+  return true;
+}
@@ -0,0 +1,45 @@
+#ifndef SPEED_MODEL_H
+#define SPEED_MODEL_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// === Speed model ===
+// Повзунок 1..20 задає максимальну швидкість профілю руху у °/с. Тривалість
+// ходу береться з тієї ж трапецієвидної моделі, за якою рухається серво
+// (motionProfileSeconds). З датчиком струму калібрування (/api/calibrateSpeed)
+// вимірює справжній кінець ходу - струм шини серво повертається до струму
+// утримання - і враховує, наскільки MG996R відстає від профілю.
+#define SPEED_CAL_POINTS 5
+
+struct SpeedCalibrationPoint {
+  uint16_t commandedDps;   // швидкість профілю
+  uint16_t sweepMs;        // виміряний хід на travelDeg: від старту до спаду струму
+};
+
+struct SpeedCalibration {
+  uint8_t version;
+  uint8_t valid;
+  int16_t travelDeg;
+  SpeedCalibrationPoint points[SPEED_CAL_POINTS];
+};
+
+extern const float SPEED_SLIDER_MIN;
+extern const float SPEED_SLIDER_MAX;
+extern const int SPEED_SLIDER_MIN_TENTHS;
+extern const int SPEED_SLIDER_MAX_TENTHS;
+extern const int SPEED_MIN_DEG_PER_SEC;
+extern const int SERVO_MOVING_CURRENT_MA;
+extern SpeedCalibration speedCalibration;
+
+// === Speed Functions ===
+void speedModelLoad(Preferences& preferences);
+int sliderToDegreesPerSecond(int sliderTenths);
+int speedToTenths(float sliderSpeed);
+float commandedDegreesPerSecond(float targetDps);
+unsigned long estimateSweepMs(float travelDeg, float targetDps);
+unsigned long estimateFeedMs(int repeats, float travelDeg, float targetDps);
+float estimateFeedEnergyMah(unsigned long feedMs);
+bool runSpeedCalibration(int fromAngle, int toAngle, Preferences& preferences);
+
+#endif
@@ -0,0 +1,34 @@
+#include "stall_detector.h"
+
+void StallDetector::reset(uint32_t nowUs) {
+  filteredMa = 0.0f;
+  peakMa = 0.0f;
+  moveStartUs = nowUs;
+  aboveSinceUs = nowUs;
+  above = false;
+  stalled = false;
+  stalledAtUs = 0;
+}
+
+bool StallDetector::update(uint32_t nowUs, float currentMa) {
+  if (stalled) return true;
+
+  filteredMa += config.filterAlpha * (currentMa - filteredMa);
+  if (filteredMa > peakMa) peakMa = filteredMa;
+
+  if (nowUs - moveStartUs < config.blankingUs) return false;
+
+  if (filteredMa < config.thresholdMa) {
+    above = false;
+    return false;
+  }
+  if (!above) {
+    above = true;
+    aboveSinceUs = nowUs;
+  }
+  if (nowUs - aboveSinceUs >= config.holdUs) {
+    stalled = true;
+    stalledAtUs = nowUs;
+  }
+  return stalled;
+}
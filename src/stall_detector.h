@@ -0,0 +1,30 @@
+#ifndef STALL_DETECTOR_H
+#define STALL_DETECTOR_H
+
+#include <stdint.h>
+
+// === Stall detector ===
+// Чиста логіка без залежностей від Arduino: на вхід - час (мкс) і струм (мА),
+// на вихід - ознака заклинювання. Можна проганяти на хості з синтетичними трасами.
+struct StallDetectorConfig {
+  float thresholdMa = 1500.0f;    // струм, вище якого вважаємо, що вал упирається
+  uint32_t blankingUs = 80000;    // ігноруємо пусковий струм на початку руху
+  uint32_t holdUs = 60000;        // скільки часу струм має триматися вище порогу
+  float filterAlpha = 0.3f;       // EMA-фільтр від шуму ШІМ
+};
+
+struct StallDetector {
+  StallDetectorConfig config;
+  float filteredMa = 0.0f;
+  float peakMa = 0.0f;
+  uint32_t moveStartUs = 0;
+  uint32_t aboveSinceUs = 0;
+  bool above = false;
+  bool stalled = false;
+  uint32_t stalledAtUs = 0;
+
+  void reset(uint32_t nowUs);
+  bool update(uint32_t nowUs, float currentMa);
+};
+
+#endif
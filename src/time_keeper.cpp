@@ -0,0 +1,236 @@
+#include "time_keeper.h"
+#include "local_time.h"
+#include "wifi_duty.h"
+#include <esp_sntp.h>
+#include <sys/time.h>
+
+static const uint32_t KEEPER_MAGIC = 0x71AE0001;
+static const uint8_t TIME_KEEP_VERSION = 1;
+static const uint32_t DRIFT_MIN_INTERVAL_S = 600;            // коротше - похибка мережі більша за дрейф
+static const uint32_t DRIFT_MAX_INTERVAL_S = 14UL * 86400UL;
+static const int64_t DRIFT_MAX_RESIDUAL_US = 10LL * 1000000LL; // більше - годинник переставляли, це не дрейф
+static const int32_t DRIFT_LIMIT_PPB = 2000000;              // ±2000 ppm
+static const uint32_t CORRECTION_PERIOD_S = 600;
+static const int64_t CORRECTION_MIN_US = 1000;
+static const uint32_t SAVE_PERIOD_S = 3600;
+static const uint32_t NTP_TRUST_S = 86400;                   // свіжий NTP не перебиваємо часом браузера
+static const uint32_t BROWSER_MIN_STEP_S = 2;
+static const uint32_t RESYNC_PERIOD_S = 6UL * 3600UL;         // далі SNTP запускаємо заново у вікні зв'язку
+static const unsigned long RESYNC_RETRY_MS = 15UL * 60000UL; // запущений клієнт сам повторює запити
+
+struct TimeKeeperState {
+  uint8_t version;
+  uint8_t reserved[3];
+  int32_t driftPpb;       // > 0: годинник відстає на стільки мкс за 1000 с
+  uint32_t lastGoodUtc;
+};
+
+// === Time keeper ===
+// Переживають deep sleep: дрейф вимірюється і через сон
+static RTC_DATA_ATTR uint32_t keeperMagic;
+static RTC_DATA_ATTR uint32_t lastSyncUtc;        // 0 - немає опорної синхронізації
+static RTC_DATA_ATTR uint32_t lastCorrectionUtc;
+static RTC_DATA_ATTR uint8_t timeSource;
+
+static Preferences* keeperPreferences = nullptr;
+static TimeKeeperState keeperState = {};
+static volatile bool sntpSynced = false;
+static uint32_t lastSaveUtc = 0;
+static uint32_t lastCorrectionCheckUtc = 0;
+static int64_t lastResidualUs = 0;
+static uint32_t syncCount = 0;
+static bool sntpQueued = false;
+static bool sntpStarted = false;
+static unsigned long sntpStartMs = 0;
+
+// Викликається з задачі lwIP: лише ставимо прапорець, обробка - у loop()
+static void onSntpSync(struct timeval*) {
+  sntpSynced = true;
+}
+
+static int64_t systemMicros() {
+  struct timeval tv;
+  gettimeofday(&tv, nullptr);
+  return static_cast<int64_t>(static_cast<uint32_t>(tv.tv_sec)) * 1000000LL + tv.tv_usec;
+}
+
+static void setSystemMicros(int64_t us) {
+  struct timeval tv;
+  tv.tv_sec = static_cast<time_t>(us / 1000000LL);
+  tv.tv_usec = static_cast<suseconds_t>(us % 1000000LL);
+  settimeofday(&tv, nullptr);
+}
+
+// Корекція накопичується між кроками; менше 1 мс не чіпаємо годинник
+static void applyDriftCorrection() {
+  if (timeSource == TIME_SOURCE_NONE) return;
+  uint32_t now = static_cast<uint32_t>(time(nullptr));
+  uint32_t elapsed = now - lastCorrectionUtc;
+  if (lastCorrectionUtc == 0 || elapsed > DRIFT_MAX_INTERVAL_S) {
+    lastCorrectionUtc = now;
+    return;
+  }
+  int64_t correctionUs = static_cast<int64_t>(keeperState.driftPpb) * elapsed / 1000;
+  if (llabs(correctionUs) < CORRECTION_MIN_US) return;
+  setSystemMicros(systemMicros() + correctionUs);
+  lastCorrectionUtc = now;
+  localClockAnchor();
+}
+
+// Місцевий годинник ще йде від попередньої прив'язки, тож різниця з новим
+// часом SNTP - це дрейф, що залишився після компенсації
+static void handleSntpSync() {
+  int64_t syncedUs = systemMicros();
+  uint32_t syncedUtc = static_cast<uint32_t>(syncedUs / 1000000LL);
+  if (timeSource == TIME_SOURCE_NTP && lastSyncUtc != 0 && localClockValid()) {
+    // Корекція, накопичена з останнього кроку, ще не застосована - це не похибка оцінки
+    int64_t estimateUs = localClockUtcMicros();
+    uint32_t pendingS = static_cast<uint32_t>(estimateUs / 1000000LL) - lastCorrectionUtc;
+    estimateUs += static_cast<int64_t>(keeperState.driftPpb) * pendingS / 1000;
+    int64_t residualUs = syncedUs - estimateUs;
+    uint32_t interval = syncedUtc - lastSyncUtc;
+    lastResidualUs = residualUs;
+    if (interval >= DRIFT_MIN_INTERVAL_S && interval <= DRIFT_MAX_INTERVAL_S &&
+        llabs(residualUs) <= DRIFT_MAX_RESIDUAL_US) {
+      int32_t residualPpb = static_cast<int32_t>(residualUs * 1000 / interval);
+      // Половина кроку згладжує шум мережевої затримки
+      keeperState.driftPpb = constrain(keeperState.driftPpb + residualPpb / 2, -DRIFT_LIMIT_PPB, DRIFT_LIMIT_PPB);
+    }
+  }
+  timeSource = TIME_SOURCE_NTP;
+  lastSyncUtc = syncedUtc;
+  lastCorrectionUtc = syncedUtc;
+  syncCount++;
+  localClockAnchor();
+  timeKeeperSave();
+}
+
+// SNTP потрібне радіо: запуск чекає найближчого вікна в черзі Wi-Fi
+static void startSntp() {
+  sntpQueued = false;
+  sntpStarted = true;
+  sntpStartMs = millis();
+  configTime(0, 0, "pool.ntp.org", "time.google.com");
+}
+
+static void requestSync() {
+  if (sntpQueued || (sntpStarted && millis() - sntpStartMs < RESYNC_RETRY_MS)) return;
+  sntpQueued = wifiDutyQueue(startSntp);
+}
+
+void timeKeeperBegin(Preferences& preferences) {
+  keeperPreferences = &preferences;
+  TimeKeeperState stored = {};
+  size_t len = preferences.getBytes("timeKeep", &stored, sizeof(stored));
+  if (len == sizeof(stored) && stored.version == TIME_KEEP_VERSION) {
+    keeperState = stored;
+  } else {
+    keeperState = {};
+    keeperState.version = TIME_KEEP_VERSION;
+  }
+
+  if (keeperMagic != KEEPER_MAGIC) {
+    // Холодний старт: вміст RTC RAM невизначений
+    keeperMagic = KEEPER_MAGIC;
+    lastSyncUtc = 0;
+    lastCorrectionUtc = 0;
+    timeSource = TIME_SOURCE_NONE;
+  }
+
+  time_t now = time(nullptr);
+  if (now < CLOCK_VALID_AFTER) {
+    // RTC втратив живлення: застарілий час кращий, ніж жодного годування
+    lastSyncUtc = 0;
+    lastCorrectionUtc = 0;
+    timeSource = TIME_SOURCE_NONE;
+    if (keeperState.lastGoodUtc >= CLOCK_VALID_AFTER) {
+      setSystemMicros(static_cast<int64_t>(keeperState.lastGoodUtc) * 1000000LL);
+      timeSource = TIME_SOURCE_RESTORED;
+      Serial.printf("Clock restored from NVS: %lu\n", static_cast<unsigned long>(keeperState.lastGoodUtc));
+    }
+  } else if (timeSource == TIME_SOURCE_NONE) {
+    timeSource = TIME_SOURCE_RTC;
+  }
+  // Після deep sleep компенсуємо дрейф за час сну
+  applyDriftCorrection();
+  lastSaveUtc = static_cast<uint32_t>(time(nullptr));
+  sntp_set_time_sync_notification_cb(onSntpSync);
+}
+
+void timeKeeperTick() {
+  if (sntpSynced) {
+    sntpSynced = false;
+    handleSntpSync();
+  }
+  // Після deep sleep зі свіжою синхронізацією вікно обходиться без SNTP
+  if (timeSource != TIME_SOURCE_NTP || static_cast<uint32_t>(localClockUtc()) - lastSyncUtc >= RESYNC_PERIOD_S) {
+    requestSync();
+  }
+  if (timeSource == TIME_SOURCE_NONE) return;
+  uint32_t now = static_cast<uint32_t>(localClockUtc());
+  if (now - lastCorrectionCheckUtc >= CORRECTION_PERIOD_S) {
+    lastCorrectionCheckUtc = now;
+    applyDriftCorrection();
+  }
+  if (now - lastSaveUtc >= SAVE_PERIOD_S) timeKeeperSave();
+}
+
+// Раз на годину і перед deep sleep: при втраті живлення відстанемо не більше ніж на годину
+void timeKeeperSave() {
+  if (!keeperPreferences || timeSource == TIME_SOURCE_NONE) return;
+  uint32_t now = static_cast<uint32_t>(time(nullptr));
+  keeperState.lastGoodUtc = now;
+  keeperPreferences->putBytes("timeKeep", &keeperState, sizeof(keeperState));
+  lastSaveUtc = now;
+}
+
+bool timeKeeperSetFromBrowser(uint32_t utc, uint16_t ms) {
+  if (utc < static_cast<uint32_t>(CLOCK_VALID_AFTER) || ms > 999) return false;
+  uint32_t now = static_cast<uint32_t>(time(nullptr));
+  if (timeSource == TIME_SOURCE_NTP && now - lastSyncUtc < NTP_TRUST_S) return false;
+  uint32_t step = utc > now ? utc - now : now - utc;
+  if (timeSource != TIME_SOURCE_NONE && timeSource != TIME_SOURCE_RESTORED && step < BROWSER_MIN_STEP_S) return false;
+
+  setSystemMicros(static_cast<int64_t>(utc) * 1000000LL + ms * 1000LL);
+  // Точність браузера - сотні мс, для оцінки дрейфу не годиться
+  timeSource = TIME_SOURCE_BROWSER;
+  lastSyncUtc = 0;
+  lastCorrectionUtc = utc;
+  localClockAnchor();
+  timeKeeperSave();
+  return true;
+}
+
+TimeSource timeKeeperSource() {
+  return static_cast<TimeSource>(timeSource);
+}
+
+const char* timeSourceName(TimeSource source) {
+  switch (source) {
+    case TIME_SOURCE_RTC: return "rtc";
+    case TIME_SOURCE_RESTORED: return "restored";
+    case TIME_SOURCE_BROWSER: return "browser";
+    case TIME_SOURCE_NTP: return "ntp";
+    default: return "none";
+  }
+}
+
+int32_t timeKeeperDriftPpb() {
+  return keeperState.driftPpb;
+}
+
+String timeKeeperToJson() {
+  int32_t ppb = keeperState.driftPpb;
+  char drift[16];
+  snprintf(drift, sizeof(drift), "%s%ld.%03ld", ppb < 0 ? "-" : "",
+           static_cast<long>(labs(ppb) / 1000), static_cast<long>(labs(ppb) % 1000));
+  uint32_t now = static_cast<uint32_t>(time(nullptr));
+  String json = "{";
+  json += "\"source\":\"" + String(timeSourceName(timeKeeperSource())) + "\",";
+  json += "\"driftPpm\":" + String(drift) + ",";
+  json += "\"lastSyncAgoS\":" + String(lastSyncUtc ? static_cast<long>(now - lastSyncUtc) : -1L) + ",";
+  json += "\"lastSyncErrorMs\":" + String(static_cast<long>(lastResidualUs / 1000)) + ",";
+  json += "\"syncs\":" + String(syncCount);
+  json += "}";
+  return json;
+}
@@ -0,0 +1,29 @@
+#ifndef TIME_KEEPER_H
+#define TIME_KEEPER_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// === Time keeper ===
+// Годинник без мережі: останній добрий час зберігається в NVS, дрейф RTC
+// оцінюється між послідовними синхронізаціями SNTP і компенсується малими
+// кроками, тож розклад працює і в режимі AP, і під час довгих збоїв мережі.
+enum TimeSource : uint8_t {
+  TIME_SOURCE_NONE = 0,
+  TIME_SOURCE_RTC,        // час пережив програмне перезавантаження
+  TIME_SOURCE_RESTORED,   // холодний старт, відновлено останній збережений час
+  TIME_SOURCE_BROWSER,    // встановлено зі сторінки (годинник телефону)
+  TIME_SOURCE_NTP,
+};
+
+// === Time Keeper Functions ===
+void timeKeeperBegin(Preferences& preferences);
+void timeKeeperTick();
+void timeKeeperSave();
+bool timeKeeperSetFromBrowser(uint32_t utc, uint16_t ms);
+TimeSource timeKeeperSource();
+const char* timeSourceName(TimeSource source);
+int32_t timeKeeperDriftPpb();
+String timeKeeperToJson();
+
+#endif
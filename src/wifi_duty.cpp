@@ -0,0 +1,218 @@
+#include "wifi_duty.h"
+#include "wifi_manager.h"
+#include "idle_governor.h"
+#include "power_profile.h"
+#include "boot_profile.h"
+#include "app_config.h"
+
+static const unsigned long CACHED_CONNECT_MS = 3000;   // далі - повне сканування
+static const unsigned long CONNECT_TIMEOUT_MS = 15000; // не вийшло - чекаємо наступного вікна
+static const unsigned long WINDOW_IDLE_GRACE_MS = 30000; // відкрита сторінка тримає вікно
+
+WifiDutyConfig wifiDutyConfig = {0, 120, 300, 60, 120};
+
+static WifiDutyState dutyState = WIFI_DUTY_RADIO_ON;
+static unsigned long windowUntilMs = 0;
+static unsigned long windowStartMs = 0;
+static unsigned long connectStartMs = 0;
+static bool connectUsedCache = false;
+static PowerState stateBeforeRadioOff = POWER_IDLE;
+static PowerState stateBeforeConnect = POWER_IDLE;   // асоціація триває кілька проходів loop()
+static WifiJob jobs[WIFI_DUTY_MAX_JOBS];
+static int jobCount = 0;
+static uint32_t windowsOpened = 0;
+static unsigned long lastConnectMs = 0;
+static bool bootConnect = false;   // перше підключення після старту: невдача - точка доступу
+static volatile bool gotIpEvent = false;
+
+static bool deadlineReached(unsigned long nowMs) {
+  return static_cast<long>(nowMs - windowUntilMs) >= 0;
+}
+
+static void openWindowFor(unsigned long nowMs, unsigned long seconds) {
+  unsigned long until = nowMs + seconds * 1000UL;
+  if (deadlineReached(nowMs) || static_cast<long>(until - windowUntilMs) > 0) windowUntilMs = until;
+}
+
+static void radioOn(unsigned long nowMs);
+
+// Викликається із задачі подій Wi-Fi: лише прапорець, обробка - у wifiDutyService()
+static void onWifiGotIp(WiFiEvent_t, WiFiEventInfo_t) {
+  gotIpEvent = true;
+}
+
+// Підключення стартує тут і йде у фоні, поки setup() вантажить решту
+void wifiDutyBegin() {
+  wifiDutyConfig = appConfig.wifiDuty;
+  // Завантаження саме є вікном
+  unsigned long nowMs = millis();
+  windowStartMs = nowMs;
+  windowUntilMs = nowMs;
+  openWindowFor(nowMs, wifiDutyConfig.checkInS);
+  WiFi.onEvent(onWifiGotIp, ARDUINO_EVENT_WIFI_STA_GOT_IP);
+  bootConnect = true;
+  radioOn(nowMs);
+}
+
+void wifiDutySetConfig(const WifiDutyConfig& config, Preferences& preferences) {
+  wifiDutyConfig = config;
+  appConfig.wifiDuty = wifiDutyConfig;
+  appConfigSave(preferences);
+  openWindowFor(millis(), wifiDutyConfig.checkInS);
+}
+
+void wifiDutyExtend(unsigned long seconds) {
+  openWindowFor(millis(), seconds);
+}
+
+// Задача виконується один раз у найближчому вікні (або одразу, якщо радіо вже на зв'язку)
+bool wifiDutyQueue(WifiJob job) {
+  for (int i = 0; i < jobCount; ++i) {
+    if (jobs[i] == job) return true;
+  }
+  if (jobCount >= WIFI_DUTY_MAX_JOBS) return false;
+  jobs[jobCount++] = job;
+  return true;
+}
+
+int wifiDutyPendingJobs() {
+  return jobCount;
+}
+
+bool wifiDutyRadioActive() {
+  return dutyState != WIFI_DUTY_RADIO_OFF;
+}
+
+static void flushJobs() {
+  int count = jobCount;
+  jobCount = 0;
+  for (int i = 0; i < count; ++i) jobs[i]();
+}
+
+static void radioOn(unsigned long nowMs) {
+  powerStateRestore(stateBeforeRadioOff);
+  stateBeforeConnect = powerStateEnter(POWER_WIFI_CONNECT);
+  bootPhaseBegin(BOOT_PHASE_WIFI);
+  connectUsedCache = wifiHasAssociationCache();
+  wifiBeginStation(connectUsedCache);
+  connectStartMs = nowMs;
+  windowStartMs = nowMs;
+  windowsOpened++;
+  dutyState = WIFI_DUTY_CONNECTING;
+  idleJobBegin();   // не засинаємо посеред асоціації
+}
+
+static void radioOff() {
+  wifiRadioOff();
+  stateBeforeRadioOff = powerStateEnter(POWER_IDLE_RADIO_OFF);
+  dutyState = WIFI_DUTY_RADIO_OFF;
+  Serial.println("Wi-Fi off until next window");
+}
+
+static void finishConnect(unsigned long nowMs) {
+  lastConnectMs = nowMs - connectStartMs;
+  Serial.printf("Wi-Fi window: connected in %lu ms%s\n", lastConnectMs, connectUsedCache ? " (cached)" : "");
+  powerStateRestore(stateBeforeConnect);
+  bootPhaseEnd(BOOT_PHASE_WIFI);
+  bootReady(BOOT_READY_WIFI);
+  bootConnect = false;
+  wifiOnConnected();
+  startNetworkServices();
+  flushJobs();
+  dutyState = WIFI_DUTY_RADIO_ON;
+  idleJobEnd();
+}
+
+static void connectingTick(unsigned long nowMs) {
+  if (WiFi.status() == WL_CONNECTED) {
+    finishConnect(nowMs);
+    return;
+  }
+  unsigned long elapsed = nowMs - connectStartMs;
+  if (connectUsedCache && elapsed >= CACHED_CONNECT_MS) {
+    connectUsedCache = false;
+    wifiForgetAssociation();
+    WiFi.disconnect();
+    wifiBeginStation(false);
+  } else if (elapsed >= CONNECT_TIMEOUT_MS) {
+    Serial.println("Wi-Fi window: connect failed");
+    powerStateRestore(stateBeforeConnect);
+    idleJobEnd();
+    bootPhaseEnd(BOOT_PHASE_WIFI);
+    if (bootConnect) {
+      // Як initWiFi(): без мережі лишаємо точку доступу для налаштування
+      bootConnect = false;
+      dutyState = WIFI_DUTY_RADIO_ON;
+      startAPMode();
+      return;
+    }
+    radioOff();
+  }
+}
+
+// Викликається з loop() раз на секунду
+void wifiDutyTick(long secondsUntilFeed) {
+  if (isAPMode || savedSSID.length() == 0) return;
+  unsigned long nowMs = millis();
+
+  if (!wifiDutyConfig.enabled) {
+    if (dutyState == WIFI_DUTY_RADIO_OFF) radioOn(nowMs);
+    if (dutyState == WIFI_DUTY_CONNECTING) connectingTick(nowMs);
+    return;
+  }
+
+  if (secondsUntilFeed >= 0 && secondsUntilFeed <= wifiDutyConfig.feedLeadS) {
+    openWindowFor(nowMs, secondsUntilFeed + wifiDutyConfig.feedAfterS);
+  }
+  if (wifiDutyConfig.checkInMin > 0 && nowMs - windowStartMs >= wifiDutyConfig.checkInMin * 60000UL) {
+    windowStartMs = nowMs;
+    openWindowFor(nowMs, wifiDutyConfig.checkInS);
+  }
+
+  switch (dutyState) {
+    case WIFI_DUTY_RADIO_OFF:
+      if (!deadlineReached(nowMs)) radioOn(nowMs);
+      break;
+    case WIFI_DUTY_CONNECTING:
+      connectingTick(nowMs);
+      break;
+    case WIFI_DUTY_RADIO_ON:
+      if (jobCount > 0 && WiFi.status() == WL_CONNECTED) flushJobs();
+      if (deadlineReached(nowMs) && idleForMs() >= WINDOW_IDLE_GRACE_MS && jobCount == 0) radioOff();
+      break;
+  }
+}
+
+// З кожного проходу loop(): IP отримано - служби і черга задач без очікування секундного тіку
+void wifiDutyService() {
+  if (!gotIpEvent) return;
+  gotIpEvent = false;
+  if (dutyState == WIFI_DUTY_CONNECTING && WiFi.status() == WL_CONNECTED) finishConnect(millis());
+}
+
+// Для губернатора сну: найближча подія, до якої треба прокинутись (-1 - невідомо)
+long wifiDutySecondsUntilWindow(long secondsUntilFeed) {
+  if (!wifiDutyConfig.enabled || dutyState != WIFI_DUTY_RADIO_OFF) return secondsUntilFeed;
+  long feedWindow = secondsUntilFeed >= 0 ? max(0L, secondsUntilFeed - static_cast<long>(wifiDutyConfig.feedLeadS)) : -1;
+  if (wifiDutyConfig.checkInMin == 0) return feedWindow;
+  long sinceStartS = static_cast<long>((millis() - windowStartMs) / 1000UL);
+  long checkIn = max(0L, static_cast<long>(wifiDutyConfig.checkInMin) * 60L - sinceStartS);
+  return feedWindow >= 0 ? min(feedWindow, checkIn) : checkIn;
+}
+
+String wifiDutyToJson() {
+  static const char* const STATE_NAMES[] = {"on", "connecting", "off"};
+  unsigned long nowMs = millis();
+  String json = "{\"enabled\":" + String(wifiDutyConfig.enabled ? "true" : "false") + ",";
+  json += "\"state\":\"" + String(STATE_NAMES[dutyState]) + "\",";
+  json += "\"windowLeftS\":" + String(deadlineReached(nowMs) ? 0UL : (windowUntilMs - nowMs) / 1000UL) + ",";
+  json += "\"feedLeadS\":" + String(wifiDutyConfig.feedLeadS) + ",";
+  json += "\"feedAfterS\":" + String(wifiDutyConfig.feedAfterS) + ",";
+  json += "\"checkInMin\":" + String(wifiDutyConfig.checkInMin) + ",";
+  json += "\"checkInS\":" + String(wifiDutyConfig.checkInS) + ",";
+  json += "\"windows\":" + String(windowsOpened) + ",";
+  json += "\"lastConnectMs\":" + String(lastConnectMs) + ",";
+  json += "\"cachedAssociation\":" + String(wifiHasAssociationCache() ? "true" : "false") + ",";
+  json += "\"pendingJobs\":" + String(jobCount) + "}";
+  return json;
+}
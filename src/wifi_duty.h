@@ -0,0 +1,44 @@
+#ifndef WIFI_DUTY_H
+#define WIFI_DUTY_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+
+// === Wi-Fi duty cycling ===
+// Радіо вимкнене між вікнами зв'язку: кілька хвилин навколо кожного годування
+// і періодичний check-in. У вікні підключаємось за кешованим BSSID/каналом
+// і виконуємо відкладені мережеві задачі.
+#define WIFI_DUTY_MAX_JOBS 8
+
+// Зберігається в AppConfig::wifiDuty
+struct WifiDutyConfig {
+  uint8_t enabled;
+  uint16_t feedLeadS;      // вмикаємо радіо за стільки секунд до годування
+  uint16_t feedAfterS;     // і тримаємо стільки після нього
+  uint16_t checkInMin;     // період check-in, 0 - лише навколо годувань
+  uint16_t checkInS;       // тривалість check-in вікна
+};
+
+typedef void (*WifiJob)();
+
+enum WifiDutyState : uint8_t {
+  WIFI_DUTY_RADIO_ON = 0,
+  WIFI_DUTY_CONNECTING,
+  WIFI_DUTY_RADIO_OFF
+};
+
+extern WifiDutyConfig wifiDutyConfig;
+
+// === Wi-Fi Duty Functions ===
+void wifiDutyBegin();
+void wifiDutySetConfig(const WifiDutyConfig& config, Preferences& preferences);
+void wifiDutyTick(long secondsUntilFeed);
+void wifiDutyService();
+void wifiDutyExtend(unsigned long seconds);
+bool wifiDutyQueue(WifiJob job);
+int wifiDutyPendingJobs();
+bool wifiDutyRadioActive();
+long wifiDutySecondsUntilWindow(long secondsUntilFeed);
+String wifiDutyToJson();
+
+#endif
@@ -1,4 +1,7 @@
 #include "wifi_manager.h"
+#include "power_profile.h"
+#include "wifi_power.h"
+#include "boot_profile.h"
 
 // === WiFi Variables ===
 String savedSSID = "";
@@ -7,24 +10,92 @@ const char* apSSID = "FishFeeder-Setup";
 const char* apPassword = "12345678";
 bool isAPMode = false;
 
+// === Association cache ===
+// BSSID і канал останньої вдалої асоціації: без сканування всіх каналів
+// підключення займає ~0.3 с замість 2-3 с. RTC RAM переживає deep sleep.
+struct WiFiAssociationCache {
+  uint32_t magic;
+  uint8_t bssid[6];
+  uint8_t channel;
+};
+
+static const uint32_t WIFI_CACHE_MAGIC = 0x57434831; // "WCH1"
+static const int WIFI_CACHED_ATTEMPTS = 6;           // 3 с на швидку спробу, далі повне сканування
+static RTC_DATA_ATTR WiFiAssociationCache associationCache;
+
+bool wifiHasAssociationCache() {
+  return associationCache.magic == WIFI_CACHE_MAGIC;
+}
+
+static void rememberAssociation() {
+  const uint8_t* bssid = WiFi.BSSID();
+  if (!bssid) return;
+  memcpy(associationCache.bssid, bssid, sizeof(associationCache.bssid));
+  associationCache.channel = static_cast<uint8_t>(WiFi.channel());
+  associationCache.magic = WIFI_CACHE_MAGIC;
+}
+
+// Не блокує: статус перевіряється в циклі через WiFi.status()
+void wifiBeginStation(bool useCache) {
+  WiFi.mode(WIFI_STA);
+  if (useCache && wifiHasAssociationCache()) {
+    WiFi.begin(savedSSID.c_str(), savedPassword.c_str(), associationCache.channel, associationCache.bssid);
+  } else {
+    WiFi.begin(savedSSID.c_str(), savedPassword.c_str());
+  }
+}
+
+void wifiOnConnected() {
+  rememberAssociation();
+  wifiPowerOnConnected();
+  isAPMode = false;
+}
+
+void wifiForgetAssociation() {
+  associationCache.magic = 0;
+}
+
+void startNetworkServices() {
+  bootPhaseBegin(BOOT_PHASE_NETWORK);
+  if(!MDNS.begin("fish")) Serial.println("Error setting up MDNS!");
+  else Serial.println("mDNS responder started: http://fish.local");
+  // SNTP запускає timeKeeperTick() через чергу вікна, коли синхронізація потрібна
+  bootPhaseEnd(BOOT_PHASE_NETWORK);
+  bootReady(BOOT_READY_NETWORK);
+}
+
+void wifiRadioOff() {
+  MDNS.end();
+  WiFi.disconnect(true);
+  WiFi.mode(WIFI_OFF);
+}
+
 // === WiFi Management Functions ===
 bool connectToWiFi() {
   if(savedSSID.length() == 0) return false;
   
-  WiFi.mode(WIFI_STA);
-  WiFi.begin(savedSSID.c_str(), savedPassword.c_str());
-  Serial.print("Connecting to WiFi: " + savedSSID);
+  PowerState previousState = powerStateEnter(POWER_WIFI_CONNECT);
+  bool cached = wifiHasAssociationCache();
+  wifiBeginStation(cached);
+  Serial.print("Connecting to WiFi: " + savedSSID + (cached ? " (cached BSSID)" : ""));
   
   int attempts = 0;
   while(WiFi.status() != WL_CONNECTED && attempts < 20) {
     delay(500);
     Serial.print(".");
     attempts++;
+    // Точка доступу могла змінити канал - повертаємось до звичайного сканування
+    if(cached && attempts == WIFI_CACHED_ATTEMPTS && WiFi.status() != WL_CONNECTED) {
+      wifiForgetAssociation();
+      WiFi.disconnect();
+      wifiBeginStation(false);
+    }
   }
+  powerStateRestore(previousState);
   
   if(WiFi.status() == WL_CONNECTED) {
     Serial.println("\nWiFi connected, IP: " + WiFi.localIP().toString());
-    isAPMode = false;
+    wifiOnConnected();
     return true;
   } else {
     Serial.println("\nFailed to connect to WiFi");
@@ -44,7 +115,7 @@ void startAPMode() {
   isAPMode = true;
 }
 
-void initWiFi(Preferences& preferences) {
+void wifiLoadCredentials(Preferences& preferences) {
   // Завантажуємо збережені WiFi дані
   savedSSID = preferences.getString("wifiSSID", "");
   savedPassword = preferences.getString("wifiPassword", "");
@@ -54,18 +125,6 @@ void initWiFi(Preferences& preferences) {
     savedSSID = "Andre Archer Connect";
     savedPassword = "1234567890abb";
   }
-  
-  // Підключаємося до WiFi
-  if(!connectToWiFi()) {
-    // Якщо не вдалося підключитися, увімкнути AP mode
-    startAPMode();
-  }
-  
-  if(!isAPMode) {
-    if(!MDNS.begin("fish")) Serial.println("Error setting up MDNS!");
-    else Serial.println("mDNS responder started: http://fish.local");
-    configTime(0,0,"pool.ntp.org","time.google.com");
-  }
 }
 
 void setupWiFiHandlers(WebServer& server, Preferences& preferences) {
@@ -651,6 +710,7 @@ void handleSetWiFi(WebServer& server, Preferences& preferences){
     savedPassword = server.arg("password");
     preferences.putString("wifiSSID", savedSSID);
     preferences.putString("wifiPassword", savedPassword);
+    wifiForgetAssociation();
     server.send(200,"text/plain","ok");
     // Даємо час відправити відповідь клієнту
     delay(500);
@@ -662,10 +722,7 @@ void handleSetWiFi(WebServer& server, Preferences& preferences){
       if(isAPMode) {
         WiFi.softAPdisconnect(true);
         isAPMode = false;
-        // Запускаємо MDNS
-        if(!MDNS.begin("fish")) Serial.println("Error setting up MDNS!");
-        else Serial.println("mDNS responder started: http://fish.local");
-        configTime(0,0,"pool.ntp.org","time.google.com");
+        startNetworkServices();
       }
     }
   } else {
@@ -676,6 +733,7 @@ void handleSetWiFi(WebServer& server, Preferences& preferences){
 void handleForgetWiFi(WebServer& server, Preferences& preferences){
   preferences.remove("wifiSSID");
   preferences.remove("wifiPassword");
+  wifiForgetAssociation();
   savedSSID = "";
   savedPassword = "";
 
@@ -696,9 +754,7 @@ void handleReconnectWiFi(WebServer& server){
     if(isAPMode) {
       WiFi.softAPdisconnect(true);
       isAPMode = false;
-      if(!MDNS.begin("fish")) Serial.println("Error setting up MDNS!");
-      else Serial.println("mDNS responder started: http://fish.local");
-      configTime(0,0,"pool.ntp.org","time.google.com");
+      startNetworkServices();
     }
   }
 }
@@ -16,8 +16,14 @@ extern bool isAPMode;
 
 // === WiFi Management Functions ===
 bool connectToWiFi();
+void wifiBeginStation(bool useCache);
+void wifiOnConnected();
+bool wifiHasAssociationCache();
+void wifiForgetAssociation();
+void startNetworkServices();
+void wifiRadioOff();
 void startAPMode();
-void initWiFi(Preferences& preferences);
+void wifiLoadCredentials(Preferences& preferences);
 void setupWiFiHandlers(WebServer& server, Preferences& preferences);
 
 // === WiFi HTML Page ===
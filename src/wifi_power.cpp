@@ -0,0 +1,105 @@
+#include "wifi_power.h"
+#include <WiFi.h>
+#include "latency_stats.h"
+#include "app_config.h"
+
+static const WifiPowerSettings PROFILE_SETTINGS[WIFI_POWER_PROFILE_COUNT] = {
+  {WIFI_PS_NONE, 3},
+  {WIFI_PS_MIN_MODEM, 3},
+  {WIFI_PS_MAX_MODEM, 10},
+};
+
+static const char* const PROFILE_NAMES[WIFI_POWER_PROFILE_COUNT] = {
+  "maxPerformance", "balanced", "minModem"
+};
+
+static const uint32_t LATENCY_MAX_VALID_MS = 60000;
+
+WifiPowerProfile wifiPowerProfile = WIFI_POWER_BALANCED;
+
+static LatencyStats profileLatency[WIFI_POWER_PROFILE_COUNT];
+static bool idleModemSleep = false;
+
+static void applyPowerSave() {
+  esp_wifi_set_ps(idleModemSleep ? WIFI_PS_MAX_MODEM : PROFILE_SETTINGS[wifiPowerProfile].ps);
+}
+
+// listen_interval зчитується лише під час асоціації
+static bool applyListenInterval() {
+  wifi_config_t config;
+  if (esp_wifi_get_config(WIFI_IF_STA, &config) != ESP_OK) return false;
+  uint16_t wanted = PROFILE_SETTINGS[wifiPowerProfile].listenInterval;
+  if (config.sta.listen_interval == wanted) return false;
+  config.sta.listen_interval = wanted;
+  esp_wifi_set_config(WIFI_IF_STA, &config);
+  return true;
+}
+
+void wifiPowerBegin() {
+  uint8_t stored = appConfig.wifiProfile;
+  wifiPowerProfile = stored < WIFI_POWER_PROFILE_COUNT ? static_cast<WifiPowerProfile>(stored) : WIFI_POWER_BALANCED;
+}
+
+bool wifiPowerSetProfile(WifiPowerProfile profile, Preferences& preferences) {
+  if (profile >= WIFI_POWER_PROFILE_COUNT) return false;
+  wifiPowerProfile = profile;
+  appConfig.wifiProfile = profile;
+  appConfigSave(preferences);
+  if (WiFi.status() == WL_CONNECTED) {
+    applyPowerSave();
+    // Новий listen interval запрацює після переасоціації
+    if (applyListenInterval()) WiFi.reconnect();
+  }
+  return true;
+}
+
+bool wifiPowerProfileFromName(const String& name, WifiPowerProfile& profile) {
+  for (int i = 0; i < WIFI_POWER_PROFILE_COUNT; ++i) {
+    if (name == PROFILE_NAMES[i]) {
+      profile = static_cast<WifiPowerProfile>(i);
+      return true;
+    }
+  }
+  return false;
+}
+
+const char* wifiPowerProfileName(WifiPowerProfile profile) {
+  return profile < WIFI_POWER_PROFILE_COUNT ? PROFILE_NAMES[profile] : "unknown";
+}
+
+void wifiPowerOnConnected() {
+  applyListenInterval();
+  applyPowerSave();
+}
+
+// Губернатор сну: без відвідувачів переходимо на максимальний modem sleep незалежно від профілю
+void wifiPowerSetIdle(bool idle) {
+  if (idle == idleModemSleep) return;
+  idleModemSleep = idle;
+  if (WiFi.status() == WL_CONNECTED) applyPowerSave();
+}
+
+// Вимір приписується профілю лише в активному стані, інакше це затримка idle-сну
+void wifiPowerRecordLatency(uint32_t ms) {
+  if (idleModemSleep || ms == 0 || ms > LATENCY_MAX_VALID_MS) return;
+  profileLatency[wifiPowerProfile].add(ms);
+}
+
+String wifiPowerToJson() {
+  String json = "{\"profile\":\"" + String(PROFILE_NAMES[wifiPowerProfile]) + "\",";
+  json += "\"idleModemSleep\":" + String(idleModemSleep ? "true" : "false") + ",";
+  json += "\"profiles\":[";
+  for (int i = 0; i < WIFI_POWER_PROFILE_COUNT; ++i) {
+    const LatencyStats& stats = profileLatency[i];
+    if (i > 0) json += ",";
+    json += "{\"name\":\"" + String(PROFILE_NAMES[i]) + "\",";
+    json += "\"listenInterval\":" + String(PROFILE_SETTINGS[i].listenInterval) + ",";
+    json += "\"samples\":" + String(stats.total) + ",";
+    json += "\"p50Ms\":" + String(stats.percentile(50)) + ",";
+    json += "\"p90Ms\":" + String(stats.percentile(90)) + ",";
+    json += "\"p99Ms\":" + String(stats.percentile(99)) + ",";
+    json += "\"maxMs\":" + String(stats.maxValue()) + "}";
+  }
+  json += "]}";
+  return json;
+}
@@ -0,0 +1,35 @@
+#ifndef WIFI_POWER_H
+#define WIFI_POWER_H
+
+#include <Arduino.h>
+#include <Preferences.h>
+#include <esp_wifi.h>
+
+// === Wi-Fi power profiles ===
+// Режим modem sleep і listen interval (у beacon-інтервалах) для кожного профілю.
+// Затримку відповіді вимірює сам браузер і передає в наступному /api/status.
+enum WifiPowerProfile : uint8_t {
+  WIFI_POWER_MAX_PERFORMANCE = 0,   // радіо не спить: найшвидший UI
+  WIFI_POWER_BALANCED,              // прокидається на кожен DTIM
+  WIFI_POWER_MIN_MODEM,             // прокидається раз на listen interval
+  WIFI_POWER_PROFILE_COUNT
+};
+
+struct WifiPowerSettings {
+  wifi_ps_type_t ps;
+  uint16_t listenInterval;
+};
+
+extern WifiPowerProfile wifiPowerProfile;
+
+// === Wi-Fi Power Functions ===
+void wifiPowerBegin();
+bool wifiPowerSetProfile(WifiPowerProfile profile, Preferences& preferences);
+bool wifiPowerProfileFromName(const String& name, WifiPowerProfile& profile);
+const char* wifiPowerProfileName(WifiPowerProfile profile);
+void wifiPowerOnConnected();
+void wifiPowerSetIdle(bool idle);
+void wifiPowerRecordLatency(uint32_t ms);
+String wifiPowerToJson();
+
+#endif
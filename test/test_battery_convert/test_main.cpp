@@ -0,0 +1,203 @@
+// Цілочисельні перетворення батареї проти колишнього float-шляху:
+//   pio test -e native -f test_battery_convert
+// Еталон - код до переходу на цілі (readBatteryVoltage/voltageToPercent) і
+// dtostrf() з ядра arduino-esp32, яким String(float, n) друкував значення.
+// На x86 float той самий IEEE binary32, що й soft-float на ESP32-C3.
+#include <unity.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "battery_convert.h"
+
+static const uint32_t DIVIDER_RATIO_X100 = 508;
+static const uint32_t CALIBRATION_PERMILLE = 1000;
+static const uint32_t RESISTANCE_MOHM = 150;
+static const uint32_t PIN_MV_MAX = 3300;            // межа АЦП з атенюацією 11 дБ
+// Спокій, серво без PWM, утримання, рух без датчика струму
+static const uint32_t LOADS_MA[] = {0, 6, 60, 900};
+
+// === Reference: float path ===
+struct RefOcvPoint {
+  uint16_t mv;
+  uint8_t percent;
+};
+
+static const RefOcvPoint REF_OCV[] = {
+  {6600, 0},  {7000, 3},  {7220, 5},  {7380, 10}, {7460, 20},
+  {7540, 30}, {7600, 40}, {7680, 50}, {7740, 60}, {7900, 70},
+  {8040, 80}, {8160, 85}, {8220, 90}, {8300, 95}, {8400, 100},
+};
+static const int REF_POINTS = sizeof(REF_OCV) / sizeof(REF_OCV[0]);
+
+static float refVoltage(uint32_t pinMv) {
+  return pinMv / 1000.0f * 5.08f * 1.0f;
+}
+
+static float refPercent(float v, float loadMa) {
+  float ocv = v + loadMa / 1000.0f * 0.15f;
+  float mv = ocv * 1000.0f;
+  if (mv <= REF_OCV[0].mv) return 0.0f;
+  if (mv >= REF_OCV[REF_POINTS - 1].mv) return 100.0f;
+  for (int i = 1; i < REF_POINTS; ++i) {
+    if (mv <= REF_OCV[i].mv) {
+      const RefOcvPoint& lo = REF_OCV[i - 1];
+      const RefOcvPoint& hi = REF_OCV[i];
+      float t = (mv - lo.mv) / static_cast<float>(hi.mv - lo.mv);
+      return lo.percent + t * (hi.percent - lo.percent);
+    }
+  }
+  return 100.0f;
+}
+
+// dtostrf() з cores/esp32/stdlib_noniso.c: додає половину молодшого розряду і відкидає решту
+static void refFormat(double number, unsigned prec, char* out) {
+  double rounding = 2.0;
+  for (unsigned i = 0; i < prec; ++i) rounding *= 10.0;
+  number += 1.0 / rounding;
+  double tenpow = 1.0;
+  unsigned digits = 1;
+  while (number >= 10.0 * tenpow) {
+    tenpow *= 10.0;
+    digits++;
+  }
+  number /= tenpow;
+  digits += prec;
+  while (digits-- > 0) {
+    int digit = static_cast<int>(number);
+    if (digit > 9) digit = 9;
+    *out++ = static_cast<char>('0' + digit);
+    if (digits == prec && prec > 0) *out++ = '.';
+    number -= digit;
+    number *= 10.0;
+  }
+  *out = '\0';
+}
+
+// Точна половина (x.xx5 В, x.5 %) на рівні раціональних чисел: float-шлях тут
+// вирішує похибка подання 5.08f, а не правило округлення, - різниця до 1 розряду
+static bool voltageIsHalfway(uint32_t units) {
+  return units % (BATTERY_UNITS_PER_MV * 10) == BATTERY_UNITS_PER_MV * 5;
+}
+
+static bool percentIsHalfway(uint32_t units, uint32_t loadMa) {
+  uint64_t ocv = units + static_cast<uint64_t>(loadMa) * RESISTANCE_MOHM * 100U;
+  for (int i = 1; i < REF_POINTS; ++i) {
+    uint64_t lo = REF_OCV[i - 1].mv * BATTERY_UNITS_PER_MV;
+    uint64_t hi = REF_OCV[i].mv * BATTERY_UNITS_PER_MV;
+    if (ocv > lo && ocv < hi) {
+      uint64_t num = (ocv - lo) * (REF_OCV[i].percent - REF_OCV[i - 1].percent);
+      return 2 * (num % (hi - lo)) == hi - lo;
+    }
+  }
+  return false;
+}
+
+static uint32_t unitsFor(uint32_t pinMv) {
+  return batteryPinToUnits(pinMv, DIVIDER_RATIO_X100, CALIBRATION_PERMILLE);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// === Tests ===
+void test_voltage_text_matches_float_path() {
+  int halfway = 0;
+  for (uint32_t pin = 0; pin <= PIN_MV_MAX; ++pin) {
+    char expected[16];
+    char actual[16];
+    refFormat(refVoltage(pin), 2, expected);
+    formatBatteryVolts(unitsFor(pin), actual, sizeof(actual));
+    char where[48];
+    snprintf(where, sizeof(where), "pinMv=%u", static_cast<unsigned>(pin));
+    if (voltageIsHalfway(unitsFor(pin))) {
+      halfway++;
+      TEST_ASSERT_FLOAT_WITHIN(0.0101, atof(expected), atof(actual));
+      continue;
+    }
+    TEST_ASSERT_EQUAL_STRING_MESSAGE(expected, actual, where);
+  }
+  // 508 x pin закінчується на 5000 лише для pin = 125 + 250k
+  TEST_ASSERT_EQUAL(13, halfway);
+}
+
+void test_percent_matches_float_path() {
+  int halfway = 0;
+  for (uint32_t load : LOADS_MA) {
+    for (uint32_t pin = 0; pin <= PIN_MV_MAX; ++pin) {
+      char expected[16];
+      refFormat(refPercent(refVoltage(pin), static_cast<float>(load)), 0, expected);
+      uint32_t actual = batteryUnitsToPercent(unitsFor(pin), load, RESISTANCE_MOHM);
+      if (percentIsHalfway(unitsFor(pin), load)) {
+        halfway++;
+        TEST_ASSERT_UINT32_WITHIN(1, atoi(expected), actual);
+        continue;
+      }
+      char where[48];
+      snprintf(where, sizeof(where), "pinMv=%u loadMa=%u", static_cast<unsigned>(pin),
+               static_cast<unsigned>(load));
+      TEST_ASSERT_EQUAL_UINT32_MESSAGE(atoi(expected), actual, where);
+    }
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(8, halfway);
+}
+
+// Подвійне округлення через цілі мВ давало "8.41" замість "8.40"
+void test_single_rounding_from_unrounded_reading() {
+  char text[16];
+  formatBatteryVolts(8404 * BATTERY_UNITS_PER_MV + 60000, text, sizeof(text));
+  TEST_ASSERT_EQUAL_STRING("8.40", text);
+  TEST_ASSERT_EQUAL_UINT32(8405, batteryUnitsToMillivolts(8404 * BATTERY_UNITS_PER_MV + 60000));
+}
+
+void test_percent_clamps_and_centi_scale() {
+  TEST_ASSERT_EQUAL_UINT32(0, batteryUnitsToPercent(6000 * BATTERY_UNITS_PER_MV, 0, RESISTANCE_MOHM));
+  TEST_ASSERT_EQUAL_UINT32(100, batteryUnitsToPercent(8500 * BATTERY_UNITS_PER_MV, 0, RESISTANCE_MOHM));
+  TEST_ASSERT_EQUAL_UINT32(10000, batteryUnitsToCentiPercent(8500 * BATTERY_UNITS_PER_MV, 0, RESISTANCE_MOHM));
+  // 7680 мВ -> 50 %; 900 мА x 0.15 Ом підіймають OCV на 135 мВ -> 7815 мВ
+  TEST_ASSERT_EQUAL_UINT32(5000, batteryUnitsToCentiPercent(7680 * BATTERY_UNITS_PER_MV, 0, RESISTANCE_MOHM));
+  TEST_ASSERT_EQUAL_UINT32(6469, batteryUnitsToCentiPercent(7680 * BATTERY_UNITS_PER_MV, 900, RESISTANCE_MOHM));
+}
+
+// На хості є FPU, тож різниця тут менша, ніж на ESP32-C3; важить порядок величин
+void test_benchmark_against_float_path() {
+  volatile uint32_t sink = 0;
+  const int rounds = 200;
+  auto start = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (uint32_t pin = 0; pin <= PIN_MV_MAX; ++pin) {
+      char text[16];
+      float v = refVoltage(pin);
+      refFormat(v, 2, text);
+      refFormat(refPercent(v, 60.0f), 0, text);
+      sink += text[0];
+    }
+  }
+  auto middle = std::chrono::steady_clock::now();
+  for (int r = 0; r < rounds; ++r) {
+    for (uint32_t pin = 0; pin <= PIN_MV_MAX; ++pin) {
+      char text[16];
+      uint32_t units = unitsFor(pin);
+      formatBatteryVolts(units, text, sizeof(text));
+      sink += text[0] + batteryUnitsToPercent(units, 60, RESISTANCE_MOHM);
+    }
+  }
+  auto end = std::chrono::steady_clock::now();
+  double calls = static_cast<double>(rounds) * (PIN_MV_MAX + 1);
+  double floatNs = std::chrono::duration<double, std::nano>(middle - start).count() / calls;
+  double intNs = std::chrono::duration<double, std::nano>(end - middle).count() / calls;
+  char message[96];
+  snprintf(message, sizeof(message), "float %.1f ns, integer %.1f ns per reading", floatNs, intNs);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(sink != 0);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_voltage_text_matches_float_path);
+  RUN_TEST(test_percent_matches_float_path);
+  RUN_TEST(test_single_rounding_from_unrounded_reading);
+  RUN_TEST(test_percent_clamps_and_centi_scale);
+  RUN_TEST(test_benchmark_against_float_path);
+  return UNITY_END();
+}
@@ -0,0 +1,366 @@
+// Рік роботи годівниці на віртуальному годиннику: справжні setup()/loop(), розклад,
+// catch-up, губернатор сну і вікна Wi-Fi з src/; сон, серво, Wi-Fi і флеш - підробки
+// з lib/host_fakes. Хронологія (годування, пробудження, витрати) - SIM_TIMELINE=1.
+//   pio test -e native -f test_schedule_sim
+#include <unity.h>
+#include <WebServer.h>
+#include <WiFi.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <vector>
+#include "host_sim.h"
+#include "event_log.h"
+#include "power_profile.h"
+#include "app_config.h"
+#include "wifi_duty.h"
+
+static const uint32_t DAY_S = 86400;
+static const int BATTERY_PIN = 2;                 // як у main.cpp
+static const uint32_t PACK_MV = 8000;             // 2S Li-ion, середина розряду
+static const uint32_t PACK_DROP_MV_PER_H = 4;      // розряд для виміру фонового струму
+static const uint32_t DIVIDER_X100 = 508;         // VOLTAGE_DIVIDER_RATIO_X100
+// Deep sleep таблиця струмів не рахує: чип, стабілізатор і дільник разом
+static const float DEEP_SLEEP_MA = 0.5f;
+static const uint32_t SLOT_LATE_MAX_S = 60;
+static const uint32_t ERASED_SEQ = 0xFFFFFFFF;
+
+// === Firmware side ===
+// Процес прошивки перед виходом кладе свій облік у спільну пам'ять
+struct BootEnergy {
+  uint64_t stateUs[POWER_STATE_COUNT];
+  float mah;
+  float drainMa;   // виміряний з історії фоновий струм, <0 - ще не виміряно
+};
+
+// Задача, поставлена в чергу Wi-Fi без радіо; лежить у спільній пам'яті після BootEnergy
+struct JobProbe {
+  uint64_t queuedUs;
+  uint64_t ranUs;
+  bool queuedWithRadioOff;
+  bool ranConnected;
+};
+
+static const char* feedTimes = "data=[{\"h\":8,\"m\":0,\"r\":1},{\"h\":18,\"m\":30,\"r\":2,\"w\":62}]";
+static const char* catchupQuery = "policy=once&graceMin=120";
+
+// Unity тут недоступний (інший процес): відмова валить прошивку, hostRun() поверне false
+static void request(const char* uri, const char* query) {
+  HostHttpResponse response = hostHttpRequest(uri, query);
+  if (response.code != 200) {
+    fprintf(stderr, "%s?%s -> %d %s\n", uri, query, response.code, response.body.c_str());
+    abort();
+  }
+}
+
+static void configureFeeder() {
+  request("/api/setTimezone", "name=UTC");
+  request("/api/setFeedTimes", feedTimes);
+  request("/api/setCatchup", catchupQuery);
+}
+
+static void holdServoPosition() {
+  request("/api/setServoSettle", "ms=0");
+}
+
+static void setupWifiWindows() {
+  request("/api/setIdle", "deepS=0");   // черга задач живе в RAM, deep sleep її не переживає
+  request("/api/setWifiDuty", "enabled=1&checkInMin=60&checkInS=120");
+}
+
+// Check-in щогодини: пів години без нікого - і deep sleep до наступного вікна
+static void setupHourlyCheckIns() {
+  request("/api/setWifiDuty", "enabled=1&checkInMin=60&checkInS=120");
+}
+
+static void dischargeBattery() {
+  uint32_t hours = static_cast<uint32_t>(hostNowUs() / 3600000000ULL);
+  hostSetPinMillivolts(BATTERY_PIN, (PACK_MV - hours * PACK_DROP_MV_PER_H) * 100 / DIVIDER_X100);
+}
+
+static JobProbe* jobProbe() {
+  return reinterpret_cast<JobProbe*>(static_cast<uint8_t*>(hostScratch(nullptr)) + sizeof(BootEnergy));
+}
+
+static void probeJob() {
+  jobProbe()->ranUs = hostNowUs();
+  jobProbe()->ranConnected = WiFi.status() == WL_CONNECTED;
+}
+
+static void queueProbeJob() {
+  jobProbe()->queuedUs = hostNowUs();
+  jobProbe()->queuedWithRadioOff = !wifiDutyRadioActive();
+  wifiDutyQueue(probeJob);
+}
+
+// Черга журналу скидається перед deep sleep; на кінці прогону - тут, при втраті живлення - ніяк
+static void onFirmwareExit(HostExit exit) {
+  if (exit == HOST_EXIT_RUN_END) eventLogFlush();
+  BootEnergy* energy = static_cast<BootEnergy*>(hostScratch(nullptr));
+  energy->mah = 0.0f;
+  for (int i = 0; i < POWER_STATE_COUNT; ++i) {
+    PowerState state = static_cast<PowerState>(i);
+    energy->stateUs[i] = powerStateMicros(state);
+    energy->mah += powerStateMah(state);
+  }
+  energy->drainMa = appConfig.drainMa;
+}
+
+// === Test side ===
+struct Feed {
+  uint32_t t;
+  uint8_t source;
+};
+
+struct SimResult {
+  std::vector<Feed> feeds;
+  uint32_t boots = 0;
+  uint32_t deepSleeps = 0;
+  uint32_t wifiConnects = 0;
+  uint32_t lightSleeps = 0;
+  uint64_t stateUs[POWER_STATE_COUNT] = {};
+  float awakeMah = 0.0f;
+  uint64_t deepSleepUs = 0;
+  uint64_t untilUs = 0;
+  uint64_t lastEndUs = 0;
+  uint64_t lastSleepUs = 0;
+  uint32_t lastSeq = 0;
+  float drainMa = -1.0f;
+};
+
+static SimResult sim;
+static bool timeline = false;
+
+static void formatUtc(uint32_t t, char* out, size_t size) {
+  time_t value = t;
+  struct tm parts;
+  gmtime_r(&value, &parts);
+  strftime(out, size, "%Y-%m-%d %H:%M:%S", &parts);
+}
+
+static uint32_t simUtc(uint64_t us) {
+  return HostSimConfig().startUtc + static_cast<uint32_t>(us / 1000000ULL);
+}
+
+// Нові записи журналу за seq; кільце між двома завантаженнями не обертається повністю
+static void readNewEvents() {
+  size_t size = 0;
+  const uint8_t* flash = hostFlash(&size);
+  std::vector<EventRecord> fresh;
+  for (size_t offset = 0; offset + sizeof(EventRecord) <= size; offset += sizeof(EventRecord)) {
+    EventRecord rec;
+    memcpy(&rec, flash + offset, sizeof(rec));
+    if (rec.seq != ERASED_SEQ && rec.seq > sim.lastSeq) fresh.push_back(rec);
+  }
+  std::sort(fresh.begin(), fresh.end(), [](const EventRecord& a, const EventRecord& b) { return a.seq < b.seq; });
+  for (const EventRecord& rec : fresh) {
+    sim.lastSeq = rec.seq;
+    if (rec.type != EVENT_FEED_START) continue;
+    sim.feeds.push_back({(rec.flags & EVENT_FLAG_UPTIME) ? 0 : rec.t, rec.source});
+    if (timeline) {
+      char when[24];
+      formatUtc(rec.t, when, sizeof(when));
+      printf("%s  feed   %-8s x%u  %u mV\n", when, eventSourceName(rec.source), rec.arg, rec.value);
+    }
+  }
+}
+
+static void addDeepSleep(uint64_t untilUs) {
+  if (sim.lastSleepUs == 0) return;
+  sim.deepSleepUs += std::min(sim.lastSleepUs, untilUs - sim.lastEndUs);
+  sim.lastSleepUs = 0;
+}
+
+static void onBoot(const HostBoot& boot) {
+  const BootEnergy* energy = static_cast<const BootEnergy*>(hostScratch(nullptr));
+  addDeepSleep(boot.bootUs);
+  sim.boots++;
+  sim.wifiConnects += boot.wifiConnects;
+  sim.lightSleeps += boot.lightSleeps;
+  sim.awakeMah += energy->mah;
+  for (int i = 0; i < POWER_STATE_COUNT; ++i) sim.stateUs[i] += energy->stateUs[i];
+  sim.lastEndUs = boot.endUs;
+  sim.drainMa = energy->drainMa;
+  if (boot.exit == HOST_EXIT_DEEP_SLEEP) {
+    sim.deepSleeps++;
+    sim.lastSleepUs = boot.sleepUs;
+  }
+
+  if (timeline) {
+    char when[24];
+    formatUtc(simUtc(boot.bootUs), when, sizeof(when));
+    printf("%s  wake   boot %u, awake %.0f s, wifi x%u, light sleep x%u, %.2f mAh\n", when, boot.index,
+           (boot.endUs - boot.bootUs) / 1e6, boot.wifiConnects, boot.lightSleeps, energy->mah);
+  }
+  readNewEvents();
+  if (timeline && boot.exit == HOST_EXIT_DEEP_SLEEP) {
+    char when[24];
+    formatUtc(simUtc(boot.endUs), when, sizeof(when));
+    printf("%s  sleep  deep %.1f h\n", when, boot.sleepUs / 3.6e9);
+  }
+}
+
+static void resetSim(uint32_t days) {
+  HostSimConfig config;
+  hostSimReset(config);
+  hostSetPinMillivolts(BATTERY_PIN, PACK_MV * 100 / DIVIDER_X100);
+  hostSetExitHook(onFirmwareExit);
+  hostAt(0, configureFeeder);
+  sim = SimResult();
+  sim.untilUs = static_cast<uint64_t>(days) * DAY_S * 1000000ULL;
+}
+
+static void runSim() {
+  TEST_ASSERT_TRUE_MESSAGE(hostRun(sim.untilUs / 1000000ULL, onBoot), "firmware crashed");
+  addDeepSleep(sim.untilUs);
+}
+
+static uint32_t feedsFrom(uint8_t source) {
+  uint32_t count = 0;
+  for (const Feed& feed : sim.feeds) {
+    if (feed.source == source) count++;
+  }
+  return count;
+}
+
+static float totalMah() {
+  return sim.awakeMah + sim.deepSleepUs / 3.6e9f * DEEP_SLEEP_MA;
+}
+
+static void reportSummary(const char* name, uint32_t days) {
+  char message[160];
+  snprintf(message, sizeof(message), "%s: %u feeds, %u boots, %u wifi, %.1f mAh/day (awake %.1f, deep sleep %.1f h/day)",
+           name, static_cast<unsigned>(sim.feeds.size()), sim.boots, sim.wifiConnects, totalMah() / days,
+           sim.awakeMah / days, sim.deepSleepUs / 3.6e9 / days);
+  TEST_MESSAGE(message);
+}
+
+void setUp() {
+  timeline = getenv("SIM_TIMELINE") != nullptr;
+}
+
+void tearDown() {}
+
+// === Tests ===
+// 08:00 щодня і 18:30 у будні: кожен слот рівно раз, вчасно, між ними - deep sleep
+void test_year_of_feeds_runs_every_slot_once() {
+  const uint32_t days = 365;
+  resetSim(days);
+  runSim();
+  reportSummary("year", days);
+
+  uint32_t expected = 0;
+  const uint32_t startUtc = HostSimConfig().startUtc;
+  for (uint32_t day = 0; day < days; ++day) {
+    time_t midnight = startUtc + day * DAY_S;
+    struct tm parts;
+    gmtime_r(&midnight, &parts);
+    expected += (parts.tm_wday >= 1 && parts.tm_wday <= 5) ? 2 : 1;
+  }
+  TEST_ASSERT_EQUAL_UINT32(expected, feedsFrom(EVENT_SOURCE_SCHEDULE));
+  TEST_ASSERT_EQUAL_UINT32(0, feedsFrom(EVENT_SOURCE_CATCHUP));
+
+  for (const Feed& feed : sim.feeds) {
+    uint32_t secondOfDay = feed.t % DAY_S;
+    uint32_t slot = secondOfDay < 13 * 3600 ? 8 * 3600 : 18 * 3600 + 30 * 60;
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(slot, secondOfDay);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(slot + SLOT_LATE_MAX_S, secondOfDay);
+  }
+
+  // Між годуваннями плата спить: не більше кількох пробуджень на добу
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(expected, sim.deepSleeps);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(4 * days, sim.boots);
+  TEST_ASSERT_TRUE(sim.deepSleepUs > 20ULL * 3600 * 1000000ULL * days);
+  TEST_ASSERT_TRUE(totalMah() / days < 50.0f);
+  // Кожне підключення, зокрема при старті, рахується як wifiConnect
+  uint64_t minConnectUs = static_cast<uint64_t>(sim.wifiConnects) * HostSimConfig().wifiCachedConnectMs * 1000ULL;
+  TEST_ASSERT_TRUE(sim.stateUs[POWER_WIFI_CONNECT] >= minConnectUs);
+}
+
+// Живлення зникло о 07:50 і повернулось о 09:00: годування о 08:00 наздоганяється раз,
+// хоча до SNTP годинник відновлено з NVS на вчорашній вечір
+void test_power_cut_over_slot_catches_up_once() {
+  resetSim(3);
+  hostPowerCut(DAY_S + 7 * 3600 + 50 * 60, 70 * 60);
+  runSim();
+  reportSummary("power cut, once", 3);
+
+  TEST_ASSERT_EQUAL_UINT32(1, feedsFrom(EVENT_SOURCE_CATCHUP));
+  for (const Feed& feed : sim.feeds) {
+    if (feed.source != EVENT_SOURCE_CATCHUP) continue;
+    uint32_t restoredUtc = HostSimConfig().startUtc + DAY_S + 9 * 3600;
+    TEST_ASSERT_GREATER_OR_EQUAL_UINT32(restoredUtc, feed.t);
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(restoredUtc + 5 * 60, feed.t);
+  }
+  // 3 ранкових + 2 вечірніх у будні (чт, пт); ранок другої доби - наздоганяння
+  TEST_ASSERT_EQUAL_UINT32(4, feedsFrom(EVENT_SOURCE_SCHEDULE));
+}
+
+void test_power_cut_with_skip_policy_drops_missed_slot() {
+  catchupQuery = "policy=skip&graceMin=120";
+  resetSim(3);
+  hostPowerCut(DAY_S + 7 * 3600 + 50 * 60, 70 * 60);
+  runSim();
+  catchupQuery = "policy=once&graceMin=120";
+  reportSummary("power cut, skip", 3);
+
+  TEST_ASSERT_EQUAL_UINT32(0, feedsFrom(EVENT_SOURCE_CATCHUP));
+  TEST_ASSERT_EQUAL_UINT32(4, feedsFrom(EVENT_SOURCE_SCHEDULE));
+}
+
+// Утримання позиції серво не тримає плату без сну
+void test_servo_holding_torque_still_sleeps() {
+  resetSim(2);
+  hostAt(1, holdServoPosition);
+  runSim();
+  reportSummary("holding torque", 2);
+
+  // Чт і пт: по два годування, між ними - deep sleep
+  TEST_ASSERT_EQUAL_UINT32(4, feedsFrom(EVENT_SOURCE_SCHEDULE));
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(4, sim.deepSleeps);
+}
+
+// Задача без радіо чекає найближчого check-in вікна і виконується, щойно є зв'язок
+void test_queued_wifi_job_runs_in_next_window() {
+  resetSim(1);
+  hostAt(1, setupWifiWindows);
+  hostAt(3 * 3600 + 20 * 60, queueProbeJob);
+  runSim();
+  reportSummary("wifi windows", 1);
+
+  const JobProbe* probe = jobProbe();
+  TEST_ASSERT_TRUE(probe->queuedWithRadioOff);
+  TEST_ASSERT_TRUE(probe->ranConnected);
+  TEST_ASSERT_TRUE(probe->ranUs > probe->queuedUs);
+  // Check-in раз на годину; з запасом на підключення і прохід light sleep
+  TEST_ASSERT_TRUE(probe->ranUs - probe->queuedUs <= 62ULL * 60 * 1000000ULL);
+}
+
+// Якір прогнозу в RTC RAM: годинні вікна розряду завершуються крізь deep sleep
+void test_forecast_measures_drain_across_deep_sleep() {
+  const uint32_t days = 3;
+  resetSim(days);
+  hostAt(1, setupHourlyCheckIns);
+  for (uint32_t hour = 1; hour <= days * 24; ++hour) hostAt(hour * 3600, dischargeBattery);
+  runSim();
+  reportSummary("hourly check-ins", days);
+
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(days * 20, sim.deepSleeps);
+  char message[64];
+  snprintf(message, sizeof(message), "measured drain %.2f mA", sim.drainMa);
+  TEST_MESSAGE(message);
+  TEST_ASSERT_TRUE(sim.drainMa > 0.0f);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_year_of_feeds_runs_every_slot_once);
+  RUN_TEST(test_power_cut_over_slot_catches_up_once);
+  RUN_TEST(test_power_cut_with_skip_policy_drops_missed_slot);
+  RUN_TEST(test_servo_holding_torque_still_sleeps);
+  RUN_TEST(test_queued_wifi_job_runs_in_next_window);
+  RUN_TEST(test_forecast_measures_drain_across_deep_sleep);
+  return UNITY_END();
+}
@@ -0,0 +1,156 @@
+// Симулятор датчика струму для StallDetector: синтетичні траси з шумом ШІМ
+// проганяються через детектор з тим самим кроком 1 кГц, що й у прошивці.
+//   pio test -e native -f test_stall_detector
+#include <unity.h>
+#include <stdio.h>
+#include "stall_detector.h"
+
+static const uint32_t SAMPLE_US = 1000;             // STALL_SAMPLE_INTERVAL_US
+static const uint32_t MOVE_US = 1200000;            // 180° на 150 °/с
+static const uint32_t NO_TRIP = 0xFFFFFFFF;
+// Фільтр доходить до порогу за кілька вибірок після стрибка струму
+static const uint32_t SETTLE_MARGIN_US = 10000;
+
+// === Synthetic traces ===
+struct Trace {
+  float baseMa = 650.0f;          // рух без навантаження
+  float noiseMa = 120.0f;         // пульсації ШІМ і шум АЦП
+  uint32_t inrushUs = 40000;      // пусковий струм на старті
+  float inrushMa = 2400.0f;
+  uint32_t spikeAtUs = 0;         // короткий сплеск (сухий корм між лопатями), 0 - немає
+  uint32_t spikeUs = 0;
+  float spikeMa = 0.0f;
+  uint32_t stallAtUs = NO_TRIP;   // з цього моменту вал заблоковано
+  float stallMa = 2200.0f;
+};
+
+// Детермінований шум: траси відтворювані між запусками
+static uint32_t noiseState = 1;
+static float noise(float amplitude) {
+  noiseState = noiseState * 1664525u + 1013904223u;
+  return ((noiseState >> 8) / static_cast<float>(1u << 24) * 2.0f - 1.0f) * amplitude;
+}
+
+static float traceMa(const Trace& trace, uint32_t elapsedUs) {
+  float ma = trace.baseMa;
+  if (elapsedUs < trace.inrushUs) ma = trace.inrushMa;
+  if (trace.spikeUs > 0 && elapsedUs >= trace.spikeAtUs && elapsedUs < trace.spikeAtUs + trace.spikeUs) {
+    ma = trace.spikeMa;
+  }
+  if (elapsedUs >= trace.stallAtUs) ma = trace.stallMa;
+  ma += noise(trace.noiseMa);
+  return ma > 0.0f ? ma : 0.0f;
+}
+
+// Повертає час від старту руху до спрацювання або NO_TRIP
+static uint32_t runTrace(const Trace& trace, uint32_t startUs = 1000000,
+                         StallDetectorConfig config = StallDetectorConfig()) {
+  StallDetector detector;
+  detector.config = config;
+  detector.reset(startUs);
+  noiseState = 1;
+  for (uint32_t elapsed = 0; elapsed <= MOVE_US; elapsed += SAMPLE_US) {
+    if (detector.update(startUs + elapsed, traceMa(trace, elapsed))) return elapsed;
+  }
+  return NO_TRIP;
+}
+
+static void reportLatency(const char* name, uint32_t latencyUs) {
+  char message[80];
+  snprintf(message, sizeof(message), "%s: stall detected %.1f ms after onset", name, latencyUs / 1000.0f);
+  TEST_MESSAGE(message);
+}
+
+void setUp() {}
+void tearDown() {}
+
+// === Tests ===
+void test_clean_move_never_trips() {
+  Trace trace;
+  TEST_ASSERT_EQUAL_UINT32(NO_TRIP, runTrace(trace));
+}
+
+void test_inrush_inside_blanking_is_ignored() {
+  Trace trace;
+  trace.inrushUs = StallDetectorConfig().blankingUs - 5000;
+  trace.inrushMa = 3500.0f;
+  TEST_ASSERT_EQUAL_UINT32(NO_TRIP, runTrace(trace));
+}
+
+void test_spike_shorter_than_hold_is_ignored() {
+  Trace trace;
+  trace.spikeAtUs = 400000;
+  trace.spikeUs = StallDetectorConfig().holdUs / 2;
+  trace.spikeMa = 2600.0f;
+  TEST_ASSERT_EQUAL_UINT32(NO_TRIP, runTrace(trace));
+}
+
+void test_stall_mid_move_detected_within_hold() {
+  const StallDetectorConfig config;
+  Trace trace;
+  trace.stallAtUs = 500000;
+  uint32_t tripUs = runTrace(trace);
+  TEST_ASSERT_TRUE(tripUs != NO_TRIP);
+  uint32_t latency = tripUs - trace.stallAtUs;
+  reportLatency("mid-move", latency);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(config.holdUs, latency);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(config.holdUs + SETTLE_MARGIN_US, latency);
+}
+
+// Вал заклинило ще до старту: пусковий струм переходить у струм упору
+void test_jam_from_start_detected_after_blanking() {
+  const StallDetectorConfig config;
+  Trace trace;
+  trace.stallAtUs = 0;
+  uint32_t tripUs = runTrace(trace);
+  TEST_ASSERT_TRUE(tripUs != NO_TRIP);
+  reportLatency("from start", tripUs);
+  TEST_ASSERT_GREATER_OR_EQUAL_UINT32(config.blankingUs + config.holdUs, tripUs);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(config.blankingUs + config.holdUs + SETTLE_MARGIN_US, tripUs);
+}
+
+// Упор трохи вище порогу з шумом, що перетинає поріг: утримання перезапускається,
+// але стабільний упор все одно ловиться
+void test_marginal_stall_with_noise() {
+  const StallDetectorConfig config;
+  Trace trace;
+  trace.stallAtUs = 300000;
+  trace.stallMa = config.thresholdMa + 150.0f;
+  trace.noiseMa = 250.0f;
+  uint32_t tripUs = runTrace(trace);
+  TEST_ASSERT_TRUE(tripUs != NO_TRIP);
+  reportLatency("marginal", tripUs - trace.stallAtUs);
+  TEST_ASSERT_LESS_OR_EQUAL_UINT32(3 * config.holdUs, tripUs - trace.stallAtUs);
+}
+
+// micros() переповнюється раз на ~71 хв: різниці без знаку мають пережити перехід
+void test_detection_across_micros_wraparound() {
+  Trace trace;
+  trace.stallAtUs = 200000;
+  uint32_t wrapped = runTrace(trace, 0xFFFFFFFFu - 150000);
+  uint32_t plain = runTrace(trace);
+  TEST_ASSERT_EQUAL_UINT32(plain, wrapped);
+}
+
+void test_lower_threshold_catches_lighter_jam() {
+  StallDetectorConfig config;
+  config.thresholdMa = 1000.0f;
+  Trace trace;
+  trace.stallAtUs = 500000;
+  trace.stallMa = 1300.0f;
+  TEST_ASSERT_EQUAL_UINT32(NO_TRIP, runTrace(trace));
+  TEST_ASSERT_TRUE(runTrace(trace, 1000000, config) != NO_TRIP);
+}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_clean_move_never_trips);
+  RUN_TEST(test_inrush_inside_blanking_is_ignored);
+  RUN_TEST(test_spike_shorter_than_hold_is_ignored);
+  RUN_TEST(test_stall_mid_move_detected_within_hold);
+  RUN_TEST(test_jam_from_start_detected_after_blanking);
+  RUN_TEST(test_marginal_stall_with_noise);
+  RUN_TEST(test_detection_across_micros_wraparound);
+  RUN_TEST(test_lower_threshold_catches_lighter_jam);
+  return UNITY_END();
+}